@@ -61,7 +61,7 @@ void TableGenerator::FillTable(TableMetadata *info, TableInsertMeta *table_meta)
         entry.emplace_back(col[i]);
       }
       RID rid;
-      bool inserted = info->table_->InsertTuple(Tuple(entry, &info->schema_), &rid, exec_ctx_->GetTransaction());
+      bool inserted = info->table_->AppendTuple(Tuple(entry, &info->schema_), &rid, exec_ctx_->GetTransaction());
       BUSTUB_ASSERT(inserted, "Sequential insertion cannot fail");
       num_inserted++;
     }
@@ -116,19 +116,33 @@ void TableGenerator::GenerateTestTables() {
   };
 
   for (auto &table_meta : insert_meta) {
-    // Create Schema
-    std::vector<Column> cols{};
-    cols.reserve(table_meta.col_meta_.size());
-    for (const auto &col_meta : table_meta.col_meta_) {
-      if (col_meta.type_ != TypeId::VARCHAR) {
-        cols.emplace_back(col_meta.name_, col_meta.type_);
-      } else {
-        cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
-      }
+    CreateTable(&table_meta);
+  }
+}
+
+void TableGenerator::GenerateBenchmarkTable(const char *name, uint32_t num_rows) {
+  TableInsertMeta table_meta{name,
+                             num_rows,
+                             {{"colA", TypeId::INTEGER, false, Dist::Serial, 0, 0},
+                              {"colB", TypeId::INTEGER, false, Dist::Uniform, 0, 9},
+                              {"colC", TypeId::INTEGER, false, Dist::Uniform, 0,
+                               std::max<uint64_t>(num_rows, 1) - 1}}};
+  CreateTable(&table_meta);
+}
+
+void TableGenerator::CreateTable(TableInsertMeta *table_meta) {
+  // Create Schema
+  std::vector<Column> cols{};
+  cols.reserve(table_meta->col_meta_.size());
+  for (const auto &col_meta : table_meta->col_meta_) {
+    if (col_meta.type_ != TypeId::VARCHAR) {
+      cols.emplace_back(col_meta.name_, col_meta.type_);
+    } else {
+      cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
     }
-    Schema schema(cols);
-    auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta.name_, schema);
-    FillTable(info, &table_meta);
   }
+  Schema schema(cols);
+  auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta->name_, schema);
+  FillTable(info, table_meta);
 }
 }  // namespace bustub
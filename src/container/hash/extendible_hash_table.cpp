@@ -0,0 +1,292 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  Page *page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (nullptr == page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  auto directory_page = reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  directory_page->SetPageId(directory_page_id_);
+  page_id_t bucket_page_id;
+  if (nullptr == buffer_pool_manager_->NewPage(&bucket_page_id)) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  directory_page->SetBucketPageId(0, bucket_page_id);
+  directory_page->SetLocalDepth(0, 0);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableDirectoryPage *EXTENDIBLE_HASH_TABLE_TYPE::FetchDirectoryPage() {
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  if (nullptr == page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *EXTENDIBLE_HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (nullptr == page) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory_page->GetBucketPageId(Hash(key) & directory_page->GetGlobalDepthMask());
+  Page *page = FetchBucketPage(bucket_page_id);
+  page->RLatch();
+  bool found = reinterpret_cast<HashTableBucket *>(page->GetData())->GetValue(key, comparator_, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory_page->GetBucketPageId(Hash(key) & directory_page->GetGlobalDepthMask());
+  Page *page = FetchBucketPage(bucket_page_id);
+  page->WLatch();
+  auto bucket_page = reinterpret_cast<HashTableBucket *>(page->GetData());
+  bool full = bucket_page->IsFull();
+  bool inserted = !full && bucket_page->Insert(key, value, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (!full) {
+    return inserted;
+  }
+  table_latch_.WLock();
+  inserted = SplitInsert(transaction, key, value);
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+/*
+ * Split the bucket of key until the pair fits. When the local depth of the
+ * bucket equals the global depth the directory doubles first. The keys of
+ * the bucket are divided by the new local depth bit, all of them may land on
+ * the same side, so the loop goes on until the bucket of key has room.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  while (true) {
+    uint32_t bucket_idx = Hash(key) & directory_page->GetGlobalDepthMask();
+    page_id_t bucket_page_id = directory_page->GetBucketPageId(bucket_idx);
+    Page *page = FetchBucketPage(bucket_page_id);
+    auto bucket_page = reinterpret_cast<HashTableBucket *>(page->GetData());
+    if (!bucket_page->IsFull()) {
+      bool inserted = bucket_page->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+      return inserted;
+    }
+    std::vector<ValueType> values;
+    bucket_page->GetValue(key, comparator_, &values);
+    uint32_t local_depth = directory_page->GetLocalDepth(bucket_idx);
+    bool duplicate = std::find(values.begin(), values.end(), value) != values.end();
+    if (duplicate || local_depth == HashTableDirectoryPage::MAX_DEPTH) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+      return false;
+    }
+    if (local_depth == directory_page->GetGlobalDepth()) {
+      directory_page->IncrGlobalDepth();
+    }
+
+    page_id_t image_page_id;
+    Page *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+    if (nullptr == image_page) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+    }
+    auto image_bucket_page = reinterpret_cast<HashTableBucket *>(image_page->GetData());
+    // 新的局部深度位为 1 的目录项指向新桶, 其余仍指向原桶
+    uint32_t high_bit = 1U << local_depth;
+    for (uint32_t i = bucket_idx & (high_bit - 1); i < directory_page->Size(); i += high_bit) {
+      directory_page->SetLocalDepth(i, local_depth + 1);
+      if ((i & high_bit) != 0) {
+        directory_page->SetBucketPageId(i, image_page_id);
+      }
+    }
+    for (slot_offset_t i = 0; i < BUCKET_ARRAY_SIZE; i++) {
+      if (bucket_page->IsReadable(i) && (Hash(bucket_page->KeyAt(i)) & high_bit) != 0) {
+        image_bucket_page->Insert(bucket_page->KeyAt(i), bucket_page->ValueAt(i), comparator_);
+        bucket_page->RemoveAt(i);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  uint32_t bucket_idx = Hash(key) & directory_page->GetGlobalDepthMask();
+  page_id_t bucket_page_id = directory_page->GetBucketPageId(bucket_idx);
+  bool can_merge = directory_page->GetLocalDepth(bucket_idx) > 0;
+  Page *page = FetchBucketPage(bucket_page_id);
+  page->WLatch();
+  auto bucket_page = reinterpret_cast<HashTableBucket *>(page->GetData());
+  bool removed = bucket_page->Remove(key, value, comparator_);
+  bool empty = bucket_page->IsEmpty();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (removed && empty && can_merge) {
+    table_latch_.WLock();
+    Merge(transaction, key);
+    table_latch_.WUnlock();
+  }
+  return removed;
+}
+
+/*
+ * Only buckets with the same local depth are merged, the empty bucket is
+ * dropped and its directory slots point to the split image. Checked again
+ * here, an insert may have filled the bucket before the write latch was taken.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key) {
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  uint32_t bucket_idx = Hash(key) & directory_page->GetGlobalDepthMask();
+  uint32_t local_depth = directory_page->GetLocalDepth(bucket_idx);
+  if (local_depth == 0) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    return;
+  }
+  uint32_t image_idx = directory_page->GetSplitImageIndex(bucket_idx);
+  page_id_t bucket_page_id = directory_page->GetBucketPageId(bucket_idx);
+  page_id_t image_page_id = directory_page->GetBucketPageId(image_idx);
+  Page *page = FetchBucketPage(bucket_page_id);
+  bool empty = reinterpret_cast<HashTableBucket *>(page->GetData())->IsEmpty();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  if (!empty || directory_page->GetLocalDepth(image_idx) != local_depth) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    return;
+  }
+  uint32_t low_bits = bucket_idx & ((1U << (local_depth - 1)) - 1);
+  for (uint32_t i = low_bits; i < directory_page->Size(); i += 1U << (local_depth - 1)) {
+    directory_page->SetBucketPageId(i, image_page_id);
+    directory_page->SetLocalDepth(i, local_depth - 1);
+  }
+  while (directory_page->CanShrink()) {
+    directory_page->DecrGlobalDepth();
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  buffer_pool_manager_->DeletePage(bucket_page_id);
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  uint32_t global_depth = directory_page->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  for (uint32_t i = 0; i < directory_page->Size(); i++) {
+    uint32_t local_depth = directory_page->GetLocalDepth(i);
+    page_id_t bucket_page_id = directory_page->GetBucketPageId(i);
+    BUSTUB_ASSERT(local_depth <= directory_page->GetGlobalDepth(), "local depth above global depth");
+    uint32_t num_slots = 0;
+    for (uint32_t j = 0; j < directory_page->Size(); j++) {
+      if (directory_page->GetBucketPageId(j) == bucket_page_id) {
+        BUSTUB_ASSERT(directory_page->GetLocalDepth(j) == local_depth, "slots of a bucket disagree on its depth");
+        BUSTUB_ASSERT((i & directory_page->GetLocalDepthMask(i)) == (j & directory_page->GetLocalDepthMask(i)),
+                      "slot points to a bucket of other hash bits");
+        num_slots++;
+      }
+    }
+    BUSTUB_ASSERT(num_slots == 1U << (directory_page->GetGlobalDepth() - local_depth), "bucket slot count mismatch");
+    Page *page = FetchBucketPage(bucket_page_id);
+    auto bucket_page = reinterpret_cast<HashTableBucket *>(page->GetData());
+    for (slot_offset_t j = 0; j < BUCKET_ARRAY_SIZE; j++) {
+      if (bucket_page->IsReadable(j)) {
+        BUSTUB_ASSERT((Hash(bucket_page->KeyAt(j)) & directory_page->GetLocalDepthMask(i)) ==
+                          (i & directory_page->GetLocalDepthMask(i)),
+                      "key in the wrong bucket");
+      }
+    }
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
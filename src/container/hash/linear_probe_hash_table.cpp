@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -26,21 +27,189 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = CreateTable(num_buckets);
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_));
+  size_ = header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  size_t old_size = result->size();
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  if (resizing) {
+    GetValueIn(old_header_page_id_, key, hash, result);
+  }
+  GetValueIn(header_page_id_, key, hash, result);
+  table_latch_.RUnlock();
+  if (resizing) {
+    // 两张表之间读的间隙里被迁移的键值对会读到两次
+    auto begin = result->begin() + old_size;
+    for (auto it = begin; it != result->end();) {
+      if (std::find(begin, it, *it) != it) {
+        it = result->erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  return result->size() > old_size;
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::GetValueIn(page_id_t header_page_id, const KeyType &key, uint64_t hash,
+                                 std::vector<ValueType> *result) {
+  uint8_t tag = HashTableBlock::TagOf(hash);
+  Probe(header_page_id, hash, false, [&](HashTableBlock *block, slot_offset_t group_ind, uint32_t live, uint32_t) {
+    for (uint32_t match = live & block->MatchTag(group_ind, tag); match != 0; match &= match - 1) {
+      slot_offset_t offset = group_ind + __builtin_ctz(match);
+      if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0) {
+        result->push_back(block->ValueAt(offset));
+      }
+    }
+    return false;
+  });
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::Contains(page_id_t header_page_id, const KeyType &key, uint64_t hash, const ValueType &value) {
+  uint8_t tag = HashTableBlock::TagOf(hash);
+  return Probe(header_page_id, hash, false,
+               [&](HashTableBlock *block, slot_offset_t group_ind, uint32_t live, uint32_t) {
+                 for (uint32_t match = live & block->MatchTag(group_ind, tag); match != 0; match &= match - 1) {
+                   slot_offset_t offset = group_ind + __builtin_ctz(match);
+                   if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0 &&
+                       block->ValueAt(offset) == value) {
+                     return true;
+                   }
+                 }
+                 return false;
+               });
+}
+
+/*
+ * Walk the probe sequence of hash. Blocks are latched one at a time and in
+ * the same order by every walk of the same key. A table holds whole blocks,
+ * so a group never wraps around the end of the table.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visit>
+bool HASH_TABLE_TYPE::Probe(page_id_t header_page_id, uint64_t hash, bool exclusive, Visit &&visit) {
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id));
+  if (nullptr == header_page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  size_t size = header_page->GetSize();
+  size_t slot = hash % size;
+  Page *page = nullptr;
+  auto release = [&]() {
+    if (exclusive) {
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), exclusive);
+  };
+  bool stopped = false;
+  bool hit_empty = false;
+  for (size_t remaining = size; remaining > 0 && !stopped && !hit_empty;) {
+    slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+    if (nullptr == page || offset == 0) {
+      if (nullptr != page) {
+        release();
+      }
+      page = buffer_pool_manager_->FetchPage(header_page->GetBlockPageId(slot / BLOCK_ARRAY_SIZE));
+      if (nullptr == page) {
+        buffer_pool_manager_->UnpinPage(header_page_id, false);
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+      }
+      if (exclusive) {
+        page->WLatch();
+      } else {
+        page->RLatch();
+      }
+    }
+    auto block = reinterpret_cast<HashTableBlock *>(page->GetData());
+    slot_offset_t group_ind = offset - offset % TAG_GROUP_SIZE;
+    size_t end = std::min<size_t>({group_ind + TAG_GROUP_SIZE, BLOCK_ARRAY_SIZE, offset + remaining});
+    // 本组里属于这次探测的槽位, 截断在第一个从未占用过的槽位之前
+    auto run = static_cast<uint32_t>(((uint64_t{1} << (end - group_ind)) - 1) &
+                                     ~((uint64_t{1} << (offset - group_ind)) - 1));
+    uint32_t empty = run & ~block->OccupiedMask(group_ind);
+    empty &= -empty;
+    uint32_t live = empty == 0 ? run : run & (empty - 1);
+    stopped = visit(block, group_ind, live, empty);
+    hit_empty = empty != 0;
+    remaining -= end - offset;
+    slot = (slot + end - offset) % size;
+  }
+  release();
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  return stopped;
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  while (true) {
+    table_latch_.RLock();
+    InsertResult res = InsertResult::DUPLICATE;
+    // 旧表里的键值对迁移时先写新表再删旧表, 所以先查旧表再插新表不会漏掉重复
+    if (old_header_page_id_ == INVALID_PAGE_ID || !Contains(old_header_page_id_, key, hash, value)) {
+      res = InsertInto(header_page_id_, key, hash, value);
+    }
+    size_t size = size_;
+    bool grow = res == InsertResult::FULL || num_occupied_ >= size * MAX_LOAD_FACTOR;
+    table_latch_.RUnlock();
+    MigrateStep();
+    if (grow) {
+      Resize(size);
+    }
+    if (res != InsertResult::FULL) {
+      return res == InsertResult::INSERTED;
+    }
+    // 表已满, 只有确实扩容了才重试
+    table_latch_.RLock();
+    bool grown = size_ > size;
+    table_latch_.RUnlock();
+    if (!grown) {
+      return false;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename HASH_TABLE_TYPE::InsertResult HASH_TABLE_TYPE::InsertInto(page_id_t header_page_id, const KeyType &key,
+                                                                   uint64_t hash, const ValueType &value) {
+  uint8_t tag = HashTableBlock::TagOf(hash);
+  InsertResult res = InsertResult::FULL;
+  Probe(header_page_id, hash, true, [&](HashTableBlock *block, slot_offset_t group_ind, uint32_t live, uint32_t empty) {
+    for (uint32_t match = live & block->MatchTag(group_ind, tag); match != 0; match &= match - 1) {
+      slot_offset_t offset = group_ind + __builtin_ctz(match);
+      if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0 &&
+          block->ValueAt(offset) == value) {
+        res = InsertResult::DUPLICATE;
+        return true;
+      }
+    }
+    if (empty != 0) {
+      block->Insert(group_ind + __builtin_ctz(empty), key, value, tag);
+      ++num_occupied_;
+      res = InsertResult::INSERTED;
+      return true;
+    }
+    return false;
+  });
+  return res;
 }
 
 /*****************************************************************************
@@ -48,21 +217,164 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  uint64_t hash = hash_fn_.GetHash(key);
+  table_latch_.RLock();
+  bool res = (old_header_page_id_ != INVALID_PAGE_ID && RemoveFrom(old_header_page_id_, key, hash, value)) ||
+             RemoveFrom(header_page_id_, key, hash, value);
+  table_latch_.RUnlock();
+  MigrateStep();
+  return res;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::RemoveFrom(page_id_t header_page_id, const KeyType &key, uint64_t hash, const ValueType &value) {
+  uint8_t tag = HashTableBlock::TagOf(hash);
+  return Probe(header_page_id, hash, true,
+               [&](HashTableBlock *block, slot_offset_t group_ind, uint32_t live, uint32_t) {
+                 for (uint32_t match = live & block->MatchTag(group_ind, tag); match != 0; match &= match - 1) {
+                   slot_offset_t offset = group_ind + __builtin_ctz(match);
+                   if (block->IsReadable(offset) && comparator_(block->KeyAt(offset), key) == 0 &&
+                       block->ValueAt(offset) == value) {
+                     block->Remove(offset);
+                     return true;
+                   }
+                 }
+                 return false;
+               });
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
+/*
+ * Only the new table is allocated here, under the write latch; the pairs are
+ * moved by MigrateStep, one block per later insert or remove. A resize still
+ * in progress is finished first.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  FinishMigration();
+  size_t max_size = HashTableHeaderPage::MaxBlocks() * BLOCK_ARRAY_SIZE;
+  if (size_ >= std::min(2 * initial_size, max_size)) {
+    table_latch_.WUnlock();
+    return;
+  }
+  old_header_page_id_ = header_page_id_;
+  old_num_blocks_ = size_ / BLOCK_ARRAY_SIZE;
+  next_migrate_block_ = 0;
+  migrated_blocks_ = 0;
+  num_occupied_ = 0;
+  header_page_id_ = CreateTable(2 * initial_size);
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_));
+  size_ = header_page->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateStep() {
+  table_latch_.RLock();
+  bool finished = false;
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    size_t block_index = next_migrate_block_++;
+    if (block_index < old_num_blocks_) {
+      MigrateBlock(block_index);
+      finished = ++migrated_blocks_ == old_num_blocks_;
+    }
+  }
+  table_latch_.RUnlock();
+  if (finished) {
+    table_latch_.WLock();
+    FinishMigration();
+    table_latch_.WUnlock();
+  }
+}
+
+/*
+ * The old block stays write latched until all its pairs are in the new table
+ * and tombstoned here, a walk that reads the old table before the new one
+ * sees every pair in at least one of them.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateBlock(size_t block_index) {
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(old_header_page_id_));
+  page_id_t block_page_id = header_page->GetBlockPageId(block_index);
+  buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+  if (nullptr == page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  page->WLatch();
+  auto block = reinterpret_cast<HashTableBlock *>(page->GetData());
+  for (slot_offset_t offset = 0; offset < BLOCK_ARRAY_SIZE; ++offset) {
+    if (block->IsReadable(offset)) {
+      KeyType key = block->KeyAt(offset);
+      InsertInto(header_page_id_, key, hash_fn_.GetHash(key), block->ValueAt(offset));
+      block->Remove(offset);
+    }
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(block_page_id, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::FinishMigration() {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  for (size_t block_index = next_migrate_block_; block_index < old_num_blocks_; ++block_index) {
+    MigrateBlock(block_index);
+  }
+  DeleteTable(old_header_page_id_);
+  old_header_page_id_ = INVALID_PAGE_ID;
+  old_num_blocks_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::CreateTable(size_t num_buckets) {
+  size_t num_blocks = std::clamp<size_t>((num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE, 1,
+                                         HashTableHeaderPage::MaxBlocks());
+  page_id_t header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (nullptr == page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header_page->SetPageId(header_page_id);
+  header_page->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; ++i) {
+    page_id_t block_page_id;
+    if (nullptr == buffer_pool_manager_->NewPage(&block_page_id)) {
+      buffer_pool_manager_->UnpinPage(header_page_id, true);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+    }
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteTable(page_id_t header_page_id) {
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id));
+  for (size_t i = 0; i < header_page->NumBlocks(); ++i) {
+    buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(i));
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  table_latch_.RLock();
+  size_t size = size_;
+  table_latch_.RUnlock();
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -22,45 +22,95 @@ AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const Aggreg
       plan_{plan},
       child_(std::move(child)),
       aht_(plan_->GetAggregates(), plan_->GetAggregateTypes()),
-      aht_iterator_(aht_.End()){}
+      aht_iterator_(aht_.End()),
+      aggregated_{} {}
 
 const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
 
-void AggregationExecutor::Init() { child_->Init(); }
+void AggregationExecutor::Init() {
+  child_->Init();
+  aggregated_ = false;
+}
+
+void AggregationExecutor::BuildOutput() {
+  const auto *having = plan_->GetHaving();
+  const Schema *output_schema = plan_->OutputSchema();
+  const auto &output_columns = output_schema->GetColumns();
+  std::vector<Value> values(output_schema->GetColumnCount());
+  for (aht_iterator_ = aht_.Begin(); aht_iterator_ != aht_.End(); ++aht_iterator_) {
+    const auto &group_bys = aht_iterator_.Key().group_bys_;
+    const auto &aggregates = aht_iterator_.Val().aggregates_;
+    if (nullptr == having || having->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()) {
+      for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = output_columns[i].GetExpr()->EvaluateAggregate(group_bys, aggregates);
+      }
+      output_.emplace_back(values, output_schema);
+    }
+  }
+}
 
 bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!aggregated_) {
+    aggregated_ = true;
+    bool res = false;
+    while (child_->Next(tuple, rid)) {
+      res = true;
+      aht_.InsertCombine(MakeKey(tuple), MakeVal(tuple));
+    }
+    if (res) {
+      BuildOutput();
+    }
+  }
   if (!output_.empty()) {
     *tuple = output_.back();
     output_.pop_back();
     return true;
   }
-  bool res = false;
-  while (child_->Next(tuple, rid)) {
-    res = true;
-    aht_.InsertCombine(MakeKey(tuple), MakeVal(tuple));
-  }
-  if (res) {
-    const auto *having = plan_->GetHaving();
-    const Schema *output_schema = plan_->OutputSchema();
-    const auto &output_columns = output_schema->GetColumns();
-    std::vector<Value> values(output_schema->GetColumnCount());
-    for (aht_iterator_ = aht_.Begin(); aht_iterator_ != aht_.End(); ++aht_iterator_) {
-      const auto &group_bys = aht_iterator_.Key().group_bys_;
-      const auto &aggregates = aht_iterator_.Val().aggregates_;
-      if (nullptr == having || having->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()) {
-        for (size_t i = 0; i < values.size(); ++i) {
-          values[i] = output_columns[i].GetExpr()->EvaluateAggregate(group_bys, aggregates);
+  return false;
+}
+
+bool AggregationExecutor::NextBatch(VectorBatch *batch) {
+  if (!aggregated_) {
+    aggregated_ = true;
+    const auto &group_by_exprs = plan_->GetGroupBys();
+    const auto &aggregate_exprs = plan_->GetAggregates();
+    std::vector<std::vector<Value>> group_by_columns(group_by_exprs.size());
+    std::vector<std::vector<Value>> aggregate_columns(aggregate_exprs.size());
+    AggregateKey key;
+    AggregateValue val;
+    key.group_bys_.resize(group_by_exprs.size());
+    val.aggregates_.resize(aggregate_exprs.size());
+    bool res = false;
+    VectorBatch child_batch;
+    while (child_->NextBatch(&child_batch)) {
+      res = true;
+      for (size_t i = 0; i < group_by_exprs.size(); ++i) {
+        group_by_exprs[i]->EvaluateBatch(child_batch, &group_by_columns[i]);
+      }
+      for (size_t i = 0; i < aggregate_exprs.size(); ++i) {
+        aggregate_exprs[i]->EvaluateBatch(child_batch, &aggregate_columns[i]);
+      }
+      for (size_t row = 0; row < child_batch.Size(); ++row) {
+        for (size_t i = 0; i < group_by_columns.size(); ++i) {
+          key.group_bys_[i] = group_by_columns[i][row];
+        }
+        for (size_t i = 0; i < aggregate_columns.size(); ++i) {
+          val.aggregates_[i] = aggregate_columns[i][row];
         }
-        output_.emplace_back(values, output_schema);
+        aht_.InsertCombine(key, val);
       }
     }
+    if (res) {
+      BuildOutput();
+    }
   }
-  if (!output_.empty()) {
-    *tuple = output_.back();
+  const Schema *output_schema = plan_->OutputSchema();
+  batch->Reset(output_schema->GetColumnCount());
+  while (!batch->IsFull() && !output_.empty()) {
+    batch->AppendTuple(output_.back(), output_schema, output_.back().GetRid());
     output_.pop_back();
-    return true;
   }
-  return false;
+  return batch->Size() > 0;
 }
 
 }  // namespace bustub
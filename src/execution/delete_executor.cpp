@@ -22,17 +22,17 @@ DeleteExecutor::DeleteExecutor(ExecutorContext *exec_ctx, const DeletePlanNode *
 void DeleteExecutor::Init() {
   auto *catalog = exec_ctx_->GetCatalog();
   table_info_ = catalog->GetTable(plan_->TableOid());
-  table_indexes_ = catalog->GetTableIndexes(table_info_->name_);
   child_executor_->Init();
 }
 
 bool DeleteExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) {
   if (child_executor_->Next(tuple, rid)) {
     if (table_info_->table_->MarkDelete(*rid, exec_ctx_->GetTransaction())) {
-      for (const auto &index_info : table_indexes_) {
+      // 写完堆表再取索引列表, 见 InsertExecutor
+      for (const auto &index_info : exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_)) {
         Index *index = index_info->index_.get();
         Tuple index_key(tuple->KeyFromTuple(table_info_->schema_, index_info->key_schema_, index->GetKeyAttrs()));
-        index->DeleteEntry(index_key, *rid, exec_ctx_->GetTransaction());
+        index_info->DeleteEntry(index_key, *rid, exec_ctx_->GetTransaction());
       }
       return true;
     }
@@ -0,0 +1,476 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/hash_join_executor.h"
+
+#include "common/exception.h"
+#include "storage/page/tmp_tuple_page.h"
+
+namespace bustub {
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      left_(std::move(left_executor)),
+      right_(std::move(right_executor)),
+      built_{},
+      build_left_{},
+      probe_{},
+      probe_end_{},
+      probe_buffer_pos_{},
+      spilled_{},
+      probe_pages_pos_{},
+      matches_pos_{} {}
+
+HashJoinExecutor::~HashJoinExecutor() { DropSpilledPages(); }
+
+void HashJoinExecutor::Init() {
+  left_->Init();
+  right_->Init();
+  table_.Clear();
+  built_ = false;
+  probe_buffer_.clear();
+  probe_buffer_pos_ = 0;
+  output_.clear();
+  DropSpilledPages();
+  spilled_ = false;
+  matches_.clear();
+  matches_pos_ = 0;
+}
+
+bool HashJoinExecutor::FetchBlock(AbstractExecutor *child, std::vector<Tuple> *tuples, size_t *bytes) {
+  Tuple tuple;
+  RID rid;
+  for (int i = 0; i < BLOCK_TUPLES_NUM; ++i) {
+    if (!child->Next(&tuple, &rid)) {
+      return false;
+    }
+    tuples->push_back(tuple);
+    *bytes += TupleBytes(tuple);
+  }
+  return true;
+}
+
+bool HashJoinExecutor::HashKey(const Tuple &tuple, bool left, hash_t *hash) const {
+  const auto &keys = left ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  const auto *schema = left ? plan_->GetLeftPlan()->OutputSchema() : plan_->GetRightPlan()->OutputSchema();
+  hash_t curr_hash = 0;
+  for (const auto *key : keys) {
+    Value value = key->Evaluate(&tuple, schema);
+    if (value.IsNull()) {
+      return false;
+    }
+    curr_hash = HashUtil::CombineHashes(curr_hash, HashUtil::HashValue(&value));
+  }
+  *hash = curr_hash;
+  return true;
+}
+
+void HashJoinExecutor::Build() {
+  size_t budget = exec_ctx_->GetMemoryBudget();
+  std::vector<Tuple> left_tuples;
+  std::vector<Tuple> right_tuples;
+  size_t left_bytes = 0;
+  size_t right_bytes = 0;
+  bool left_more = true;
+  bool right_more = true;
+  while (left_more && right_more && (0 == budget || left_bytes + right_bytes <= budget)) {
+    left_more = FetchBlock(left_.get(), &left_tuples, &left_bytes);
+    right_more = FetchBlock(right_.get(), &right_tuples, &right_bytes);
+  }
+  build_left_ = !left_more && (right_more || left_bytes <= right_bytes);
+  if ((left_more && right_more) || (0 != budget && (build_left_ ? left_bytes : right_bytes) > budget)) {
+    Spill(&left_tuples, left_more, &right_tuples, right_more);
+    return;
+  }
+  const auto &build_tuples = build_left_ ? left_tuples : right_tuples;
+  for (const auto &tuple : build_tuples) {
+    hash_t hash;
+    if (HashKey(tuple, build_left_, &hash)) {
+      table_.Insert(tuple, hash);
+    }
+  }
+  table_.Build();
+  probe_ = build_left_ ? right_.get() : left_.get();
+  probe_end_ = !(build_left_ ? right_more : left_more);
+  probe_buffer_ = std::move(build_left_ ? right_tuples : left_tuples);
+  probe_buffer_pos_ = 0;
+}
+
+/*****************************************************************************
+ * SPILLING
+ *****************************************************************************/
+void HashJoinExecutor::Spill(std::vector<Tuple> *left_tuples, bool left_more, std::vector<Tuple> *right_tuples,
+                             bool right_more) {
+  spilled_ = true;
+  probe_end_ = true;
+  std::vector<Partition> partitions[2];
+  for (bool left : {true, false}) {
+    std::vector<Tuple> *tuples = left ? left_tuples : right_tuples;
+    AbstractExecutor *child = (left ? left_more : right_more) ? (left ? left_.get() : right_.get()) : nullptr;
+    size_t pos = 0;
+    RID rid;
+    partitions[left ? 0 : 1] = PartitionTuples(left, 0, [&](Tuple *tuple) {
+      if (pos < tuples->size()) {
+        *tuple = (*tuples)[pos++];
+        return true;
+      }
+      return nullptr != child && child->Next(tuple, &rid);
+    });
+    tuples->clear();
+  }
+  for (size_t i = 0; i < NUM_PARTITIONS; ++i) {
+    pending_.push_back(PartitionPair{std::move(partitions[0][i]), std::move(partitions[1][i]), 0});
+  }
+}
+
+template <typename Source>
+std::vector<HashJoinExecutor::Partition> HashJoinExecutor::PartitionTuples(bool left, uint32_t level,
+                                                                           Source &&next) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  std::vector<Partition> partitions(NUM_PARTITIONS);
+  std::vector<TmpTuplePage *> pages(NUM_PARTITIONS, nullptr);
+  auto unpin_all = [&]() {
+    for (auto *page : pages) {
+      if (nullptr != page) {
+        bpm->UnpinPage(page->GetTablePageId(), true);
+      }
+    }
+  };
+  Tuple tuple;
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  while (next(&tuple)) {
+    hash_t hash;
+    if (!HashKey(tuple, left, &hash)) {
+      continue;
+    }
+    // 每层用不同的哈希位划分, 同一分区再划分时才能分开
+    size_t i = HashUtil::Mix(hash + level) % NUM_PARTITIONS;
+    if (nullptr == pages[i] || !pages[i]->Insert(tuple, &tmp_tuple)) {
+      if (nullptr != pages[i]) {
+        bpm->UnpinPage(pages[i]->GetTablePageId(), true);
+      }
+      page_id_t page_id;
+      pages[i] = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+      if (nullptr == pages[i]) {
+        unpin_all();
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+      }
+      pages[i]->Init(page_id, PAGE_SIZE);
+      partitions[i].pages_.push_back(page_id);
+      bool inserted = pages[i]->Insert(tuple, &tmp_tuple);
+      BUSTUB_ASSERT(inserted, "A tuple must fit in an empty page.");
+    }
+    partitions[i].bytes_ += TupleBytes(tuple);
+  }
+  unpin_all();
+  return partitions;
+}
+
+std::vector<HashJoinExecutor::Partition> HashJoinExecutor::Repartition(Partition *partition, bool left,
+                                                                       uint32_t level) {
+  size_t page_pos = 0;
+  std::vector<Tuple> tuples;
+  size_t pos = 0;
+  auto partitions = PartitionTuples(left, level, [&](Tuple *tuple) {
+    while (pos == tuples.size()) {
+      if (page_pos == partition->pages_.size()) {
+        return false;
+      }
+      tuples.clear();
+      pos = 0;
+      ReadPartitionPage(partition->pages_[page_pos++], &tuples);
+    }
+    *tuple = tuples[pos++];
+    return true;
+  });
+  partition->pages_.clear();
+  partition->bytes_ = 0;
+  return partitions;
+}
+
+void HashJoinExecutor::ReadPartitionPage(page_id_t page_id, std::vector<Tuple> *tuples) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  auto page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+  if (nullptr == page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  page->GetTuples(tuples);
+  bpm->UnpinPage(page_id, false);
+  bpm->DeletePage(page_id);
+}
+
+void HashJoinExecutor::DropPartition(Partition *partition) {
+  for (page_id_t page_id : partition->pages_) {
+    exec_ctx_->GetBufferPoolManager()->DeletePage(page_id);
+  }
+  partition->pages_.clear();
+  partition->bytes_ = 0;
+}
+
+void HashJoinExecutor::DropSpilledPages() {
+  for (auto &pair : pending_) {
+    DropPartition(&pair.left_);
+    DropPartition(&pair.right_);
+  }
+  pending_.clear();
+  for (; probe_pages_pos_ < probe_pages_.size(); ++probe_pages_pos_) {
+    exec_ctx_->GetBufferPoolManager()->DeletePage(probe_pages_[probe_pages_pos_]);
+  }
+  probe_pages_.clear();
+  probe_pages_pos_ = 0;
+}
+
+bool HashJoinExecutor::NextPartitionPair() {
+  size_t budget = exec_ctx_->GetMemoryBudget();
+  while (!pending_.empty()) {
+    PartitionPair pair = std::move(pending_.back());
+    pending_.pop_back();
+    if (pair.left_.pages_.empty() || pair.right_.pages_.empty()) {
+      DropPartition(&pair.left_);
+      DropPartition(&pair.right_);
+      continue;
+    }
+    bool build_left = pair.left_.bytes_ <= pair.right_.bytes_;
+    Partition &build = build_left ? pair.left_ : pair.right_;
+    Partition &probe = build_left ? pair.right_ : pair.left_;
+    if (build.bytes_ > budget && pair.level_ + 1 < MAX_LEVELS) {
+      auto lefts = Repartition(&pair.left_, true, pair.level_ + 1);
+      auto rights = Repartition(&pair.right_, false, pair.level_ + 1);
+      for (size_t i = 0; i < NUM_PARTITIONS; ++i) {
+        pending_.push_back(PartitionPair{std::move(lefts[i]), std::move(rights[i]), pair.level_ + 1});
+      }
+      continue;
+    }
+    table_.Clear();
+    std::vector<Tuple> tuples;
+    for (page_id_t page_id : build.pages_) {
+      ReadPartitionPage(page_id, &tuples);
+    }
+    build.pages_.clear();
+    for (const auto &tuple : tuples) {
+      hash_t hash;
+      HashKey(tuple, build_left, &hash);
+      table_.Insert(tuple, hash);
+    }
+    table_.Build();
+    build_left_ = build_left;
+    probe_pages_ = std::move(probe.pages_);
+    probe_pages_pos_ = 0;
+    return true;
+  }
+  return false;
+}
+
+/*****************************************************************************
+ * PROBING
+ *****************************************************************************/
+bool HashJoinExecutor::NextProbeTuple(Tuple *tuple, RID *rid) {
+  while (probe_buffer_pos_ == probe_buffer_.size()) {
+    probe_buffer_.clear();
+    probe_buffer_pos_ = 0;
+    if (!spilled_) {
+      if (probe_end_ || !probe_->Next(tuple, rid)) {
+        probe_end_ = true;
+        return false;
+      }
+      return true;
+    }
+    if (probe_pages_pos_ < probe_pages_.size()) {
+      ReadPartitionPage(probe_pages_[probe_pages_pos_++], &probe_buffer_);
+    } else if (!NextPartitionPair()) {
+      return false;
+    }
+  }
+  *tuple = probe_buffer_[probe_buffer_pos_++];
+  return true;
+}
+
+void HashJoinExecutor::ProbeTuple(const Tuple &probe_tuple) {
+  hash_t hash;
+  if (!HashKey(probe_tuple, !build_left_, &hash)) {
+    return;
+  }
+  const auto *left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const auto *right_schema = plan_->GetRightPlan()->OutputSchema();
+  const auto *output_schema = plan_->OutputSchema();
+  const auto &left_keys = plan_->GetLeftKeys();
+  const auto &right_keys = plan_->GetRightKeys();
+  const auto *predicate = plan_->Predicate();
+  table_.Probe(hash, [&](const Tuple &build_tuple) {
+    const Tuple &left_tuple = build_left_ ? build_tuple : probe_tuple;
+    const Tuple &right_tuple = build_left_ ? probe_tuple : build_tuple;
+    for (size_t i = 0; i < left_keys.size(); ++i) {
+      Value left_value = left_keys[i]->Evaluate(&left_tuple, left_schema);
+      Value right_value = right_keys[i]->Evaluate(&right_tuple, right_schema);
+      if (left_value.CompareEquals(right_value) != CmpBool::CmpTrue) {
+        return;
+      }
+    }
+    if (nullptr != predicate &&
+        !predicate->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+      return;
+    }
+    std::vector<Value> values(output_schema->GetColumnCount());
+    const auto &output_columns = output_schema->GetColumns();
+    for (size_t k = 0; k < values.size(); ++k) {
+      values[k] = output_columns[k].GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema);
+    }
+    output_.emplace_back(values, output_schema);
+  });
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!built_) {
+    Build();
+    built_ = true;
+  }
+  while (output_.empty()) {
+    Tuple probe_tuple;
+    if (!NextProbeTuple(&probe_tuple, rid)) {
+      return false;
+    }
+    ProbeTuple(probe_tuple);
+  }
+  *tuple = output_.back();
+  output_.pop_back();
+  return true;
+}
+
+/*****************************************************************************
+ * BATCH PROBING
+ *****************************************************************************/
+bool HashJoinExecutor::NextProbeBatch() {
+  const auto *schema = build_left_ ? plan_->GetRightPlan()->OutputSchema() : plan_->GetLeftPlan()->OutputSchema();
+  probe_batch_.Reset(schema->GetColumnCount());
+  while (!probe_batch_.IsFull()) {
+    if (probe_buffer_pos_ < probe_buffer_.size()) {
+      const Tuple &tuple = probe_buffer_[probe_buffer_pos_++];
+      probe_batch_.AppendTuple(tuple, schema, tuple.GetRid());
+      continue;
+    }
+    probe_buffer_.clear();
+    probe_buffer_pos_ = 0;
+    if (spilled_ && probe_pages_pos_ < probe_pages_.size()) {
+      ReadPartitionPage(probe_pages_[probe_pages_pos_++], &probe_buffer_);
+      continue;
+    }
+    // 下一对分区会重建哈希表, 已取的行要先探测完
+    if (probe_batch_.Size() > 0) {
+      break;
+    }
+    if (!spilled_) {
+      if (probe_end_ || !probe_->NextBatch(&probe_batch_)) {
+        probe_end_ = true;
+        return false;
+      }
+      return true;
+    }
+    if (!NextPartitionPair()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HashJoinExecutor::MatchProbeBatch() {
+  matches_.clear();
+  matches_pos_ = 0;
+  const auto &keys = build_left_ ? plan_->GetRightKeys() : plan_->GetLeftKeys();
+  probe_keys_.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i]->EvaluateBatch(probe_batch_, &probe_keys_[i]);
+  }
+  for (size_t row = 0; row < probe_batch_.Size(); ++row) {
+    hash_t hash = 0;
+    bool null_key = false;
+    for (const auto &column : probe_keys_) {
+      if (column[row].IsNull()) {
+        null_key = true;
+        break;
+      }
+      hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&column[row]));
+    }
+    if (!null_key) {
+      table_.Probe(hash, [&](const Tuple &build_tuple) { matches_.emplace_back(row, &build_tuple); });
+    }
+  }
+}
+
+void HashJoinExecutor::EmitMatches(VectorBatch *batch) {
+  const auto *left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const auto *right_schema = plan_->GetRightPlan()->OutputSchema();
+  const auto *build_schema = build_left_ ? left_schema : right_schema;
+  const auto &build_keys = build_left_ ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  VectorBatch left_rows;
+  VectorBatch right_rows;
+  left_rows.Reset(left_schema->GetColumnCount());
+  right_rows.Reset(right_schema->GetColumnCount());
+  VectorBatch &build_rows = build_left_ ? left_rows : right_rows;
+  VectorBatch &probe_rows = build_left_ ? right_rows : left_rows;
+  // 哈希相等的行再比较连接键, 只收集键相等的行
+  for (; matches_pos_ < matches_.size() && batch->Size() + build_rows.Size() < VectorBatch::CAPACITY;
+       ++matches_pos_) {
+    auto [row, build_tuple] = matches_[matches_pos_];
+    bool equal = true;
+    for (size_t i = 0; i < build_keys.size() && equal; ++i) {
+      equal = build_keys[i]->Evaluate(build_tuple, build_schema).CompareEquals(probe_keys_[i][row]) == CmpBool::CmpTrue;
+    }
+    if (equal) {
+      probe_rows.AppendRow(probe_batch_, row);
+      build_rows.AppendTuple(*build_tuple, build_schema, build_tuple->GetRid());
+    }
+  }
+  if (nullptr != plan_->Predicate()) {
+    std::vector<Value> selection;
+    plan_->Predicate()->EvaluateJoinBatch(left_rows, right_rows, &selection);
+    left_rows.Filter(selection);
+    right_rows.Filter(selection);
+  }
+
+  const auto &output_columns = plan_->OutputSchema()->GetColumns();
+  std::vector<Value> column;
+  for (uint32_t i = 0; i < output_columns.size(); ++i) {
+    output_columns[i].GetExpr()->EvaluateJoinBatch(left_rows, right_rows, &column);
+    auto &output = batch->GetColumn(i);
+    output.insert(output.end(), column.begin(), column.end());
+  }
+  auto &rids = batch->GetRids();
+  rids.insert(rids.end(), left_rows.GetRids().begin(), left_rows.GetRids().end());
+}
+
+bool HashJoinExecutor::NextBatch(VectorBatch *batch) {
+  if (!built_) {
+    Build();
+    built_ = true;
+  }
+  const auto *output_schema = plan_->OutputSchema();
+  batch->Reset(output_schema->GetColumnCount());
+  // 先交出 Next 剩下的结果
+  while (!batch->IsFull() && !output_.empty()) {
+    batch->AppendTuple(output_.back(), output_schema, output_.back().GetRid());
+    output_.pop_back();
+  }
+  while (!batch->IsFull()) {
+    if (matches_pos_ < matches_.size()) {
+      EmitMatches(batch);
+      continue;
+    }
+    if (!NextProbeBatch()) {
+      break;
+    }
+    MatchProbeBatch();
+  }
+  return batch->Size() > 0;
+}
+
+}  // namespace bustub
@@ -11,29 +11,247 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+
+#include "common/config.h"
+#include "execution/expressions/column_value_expression.h"
+#include "type/value_factory.h"
+
 namespace bustub {
+
+class IndexScanExecutor::Cursor {
+ public:
+  virtual ~Cursor() = default;
+
+  /**
+   * Move to the next entry.
+   * @param[out] rid rid of the entry
+   * @param[out] key_values if not null, the key columns of the entry are decoded into their table positions
+   * @return false at the end of the range
+   */
+  virtual bool Next(RID *rid, std::vector<Value> *key_values) = 0;
+};
+
+template <class KeyType, class ValueType, class KeyComparator>
+class IndexScanExecutor::TreeCursor : public IndexScanExecutor::Cursor {
+ public:
+  TreeCursor(BPlusTreeIndex<KeyType, ValueType, KeyComparator> *index, const Tuple *low_key, const Tuple *high_key,
+             bool low_inclusive, bool high_inclusive)
+      : index_(index), end_iter_(index->GetEndIterator()) {
+    if (nullptr == low_key && nullptr == high_key) {
+      iter_ = index->GetBeginIterator();
+      return;
+    }
+    KeyType low;
+    KeyType high;
+    if (nullptr != low_key) {
+      low.SetFromKey(*low_key);
+    }
+    if (nullptr != high_key) {
+      high.SetFromKey(*high_key);
+    }
+    iter_ = index->GetBeginIterator(nullptr == low_key ? nullptr : &low, nullptr == high_key ? nullptr : &high,
+                                    low_inclusive, high_inclusive);
+  }
+
+  bool Next(RID *rid, std::vector<Value> *key_values) override {
+    if (iter_ == end_iter_) {
+      return false;
+    }
+    const auto &entry = *iter_;
+    *rid = entry.second;
+    if (nullptr != key_values) {
+      const auto &key_attrs = index_->GetKeyAttrs();
+      for (uint32_t i = 0; i < key_attrs.size(); ++i) {
+        (*key_values)[key_attrs[i]] = entry.first.ToValue(index_->GetKeySchema(), i);
+      }
+    }
+    ++iter_;
+    return true;
+  }
+
+ private:
+  BPlusTreeIndex<KeyType, ValueType, KeyComparator> *index_;
+  IndexIterator<KeyType, ValueType, KeyComparator> iter_;
+  IndexIterator<KeyType, ValueType, KeyComparator> end_iter_;
+};
+
+class IndexScanExecutor::VarlenCursor : public IndexScanExecutor::Cursor {
+ public:
+  VarlenCursor(VarlenBPlusTreeIndex *index, const Tuple *low_key, const Tuple *high_key, bool low_inclusive,
+               bool high_inclusive)
+      : index_(index), comparator_(index->GetKeySchema()), low_inclusive_(low_inclusive), high_inclusive_(high_inclusive) {
+    if (nullptr != low_key) {
+      has_low_key_ = true;
+      low_key_ = *low_key;
+      iter_ = index->GetBeginIterator(low_key_);
+    } else {
+      iter_ = index->GetBeginIterator();
+    }
+    if (nullptr != high_key) {
+      has_high_key_ = true;
+      high_key_ = *high_key;
+    }
+  }
+
+  bool Next(RID *rid, std::vector<Value> *key_values) override {
+    for (; !iter_.isEnd(); ++iter_) {
+      const auto &entry = *iter_;
+      VarlenKey key(entry.first);
+      if (has_low_key_ && !low_inclusive_ && comparator_(key, VarlenKey(low_key_)) == 0) {
+        continue;
+      }
+      if (has_high_key_) {
+        int cmp = comparator_(key, VarlenKey(high_key_));
+        if (cmp > 0 || (cmp == 0 && !high_inclusive_)) {
+          return false;
+        }
+      }
+      *rid = entry.second;
+      if (nullptr != key_values) {
+        const auto &key_attrs = index_->GetKeyAttrs();
+        for (uint32_t i = 0; i < key_attrs.size(); ++i) {
+          (*key_values)[key_attrs[i]] = key.ToValue(index_->GetKeySchema(), i);
+        }
+      }
+      ++iter_;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  VarlenBPlusTreeIndex *index_;
+  VarlenComparator comparator_;
+  VarlenIndexIterator iter_;
+  Tuple low_key_;
+  Tuple high_key_;
+  bool has_low_key_{false};
+  bool has_high_key_{false};
+  bool low_inclusive_;
+  bool high_inclusive_;
+};
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
       plan_{plan},
       predicate_{plan->GetPredicate()},
       index_info_{exec_ctx->GetCatalog()->GetIndex(plan->GetIndexOid())} {}
 
+IndexScanExecutor::~IndexScanExecutor() = default;
+
+template <class KeyType, class ValueType, class KeyComparator>
+std::unique_ptr<IndexScanExecutor::Cursor> IndexScanExecutor::MakeCursor(const Tuple *low_key, const Tuple *high_key) {
+  auto *index = dynamic_cast<BPlusTreeIndex<KeyType, ValueType, KeyComparator> *>(index_info_->index_.get());
+  if (nullptr == index) {
+    return nullptr;
+  }
+  return std::make_unique<TreeCursor<KeyType, ValueType, KeyComparator>>(
+      index, low_key, high_key, plan_->IsLowKeyInclusive(), plan_->IsHighKeyInclusive());
+}
+
 void IndexScanExecutor::Init() {
+  index_info_->WaitUntilReady();
   table_meta_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
-  auto *b_plus_index =
-      dynamic_cast<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> *>(index_info_->index_.get());
-  if (b_plus_index == nullptr) {
-    throw std::bad_cast();
+  cursor_.reset();
+  // TablePage::GetTuple 给元组加共享锁, 索引里的键不加锁就读, 可能读到未提交的数据
+  covering_ = !enable_logging && IsCoveredByIndex();
+  if (covering_) {
+    // 不在索引里的列不会被读到, 只是占位, 让元组保持表的布局
+    const auto &columns = table_meta_->schema_.GetColumns();
+    covering_values_.clear();
+    for (const auto &column : columns) {
+      covering_values_.push_back(column.IsInlined() ? ValueFactory::GetNullValueByType(column.GetType())
+                                                    : ValueFactory::GetVarcharValue(""));
+    }
+  }
+  // 谓词是索引键上的范围, 只扫描范围内的叶子页
+  std::unique_ptr<Tuple> low_key;
+  std::unique_ptr<Tuple> high_key;
+  const auto &key_attrs = index_info_->index_->GetKeyAttrs();
+  if (plan_->HasKeyRange() && key_attrs.size() == 1 && key_attrs[0] == plan_->GetKeyColIdx()) {
+    const TypeId col_type = table_meta_->schema_.GetColumn(plan_->GetKeyColIdx()).GetType();
+    bool low_ok = !plan_->HasLowKey() || plan_->GetLowKey().GetTypeId() == col_type;
+    bool high_ok = !plan_->HasHighKey() || plan_->GetHighKey().GetTypeId() == col_type;
+    if (low_ok && high_ok) {
+      if (plan_->HasLowKey()) {
+        low_key = std::make_unique<Tuple>(std::vector<Value>{plan_->GetLowKey()}, &index_info_->key_schema_);
+      }
+      if (plan_->HasHighKey()) {
+        high_key = std::make_unique<Tuple>(std::vector<Value>{plan_->GetHighKey()}, &index_info_->key_schema_);
+      }
+    }
+  }
+  auto *varlen_index = dynamic_cast<VarlenBPlusTreeIndex *>(index_info_->index_.get());
+  if (nullptr != varlen_index) {
+    cursor_ = std::make_unique<VarlenCursor>(varlen_index, low_key.get(), high_key.get(), plan_->IsLowKeyInclusive(),
+                                             plan_->IsHighKeyInclusive());
+    return;
+  }
+  // Catalog::CreateIndex 对单个整数列会换成 IntegerKey, 逐个尝试实例化过的类型
+  using MakeCursorFn = std::unique_ptr<Cursor> (IndexScanExecutor::*)(const Tuple *, const Tuple *);
+  for (MakeCursorFn make_cursor : {&IndexScanExecutor::MakeCursor<IntegerKey<int32_t>, RID, IntegerComparator<int32_t>>,
+                                   &IndexScanExecutor::MakeCursor<IntegerKey<int64_t>, RID, IntegerComparator<int64_t>>,
+                                   &IndexScanExecutor::MakeCursor<GenericKey<4>, RID, GenericComparator<4>>,
+                                   &IndexScanExecutor::MakeCursor<GenericKey<8>, RID, GenericComparator<8>>}) {
+    cursor_ = (this->*make_cursor)(low_key.get(), high_key.get());
+    if (cursor_ != nullptr) {
+      return;
+    }
+  }
+  throw std::bad_cast();
+}
+
+/*
+ * The scan is covering when the predicate and the output only read key columns,
+ * and the key columns can be decoded straight from the index key. Init only uses
+ * it with logging off, since a covering scan takes no tuple locks.
+ */
+bool IndexScanExecutor::IsCoveredByIndex() const {
+  const Schema *key_schema = index_info_->index_->GetKeySchema();
+  const auto &key_attrs = index_info_->index_->GetKeyAttrs();
+  // key 是按 index_info_->key_schema_ 的偏移写入的, 与表列类型算出的偏移一致才能直接解码
+  if (key_schema->GetLength() > index_info_->key_size_ ||
+      index_info_->key_schema_.GetColumnCount() != key_schema->GetColumnCount()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); ++i) {
+    const auto &column = key_schema->GetColumn(i);
+    if (!column.IsInlined() || column.GetOffset() != index_info_->key_schema_.GetColumn(i).GetOffset()) {
+      return false;
+    }
+  }
+  std::vector<uint32_t> col_idxs;
+  if (nullptr != predicate_) {
+    CollectColumnIdxs(predicate_, &col_idxs);
+  }
+  for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+    CollectColumnIdxs(column.GetExpr(), &col_idxs);
+  }
+  return std::all_of(col_idxs.begin(), col_idxs.end(), [&key_attrs](uint32_t col_idx) {
+    return std::find(key_attrs.begin(), key_attrs.end(), col_idx) != key_attrs.end();
+  });
+}
+
+void IndexScanExecutor::CollectColumnIdxs(const AbstractExpression *expr, std::vector<uint32_t> *col_idxs) {
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr);
+  if (nullptr != column_expr) {
+    col_idxs->push_back(column_expr->GetColIdx());
+  }
+  for (const auto *child : expr->GetChildren()) {
+    CollectColumnIdxs(child, col_idxs);
   }
-  iter_ = b_plus_index->GetBeginIterator();
-  end_iter_ = b_plus_index->GetEndIterator();
 }
 
 bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
-  while (iter_ != end_iter_) {
-    *rid = (*iter_).second;
-    ++iter_;
-    table_meta_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction());
+  while (cursor_->Next(rid, covering_ ? &covering_values_ : nullptr)) {
+    if (covering_) {
+      // index-only: 从索引键还原出表元组里用到的列, 不访问堆表
+      *tuple = Tuple(covering_values_, &table_meta_->schema_);
+    } else if (!table_meta_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
+      // 堆表里的元组已删除, 或没拿到共享锁
+      continue;
+    }
     if (nullptr == predicate_ || predicate_->Evaluate(tuple, &table_meta_->schema_).GetAs<bool>()) {
       const Schema *output_scheme = plan_->OutputSchema();
       std::vector<Value> values(output_scheme->GetColumnCount());
@@ -22,7 +22,6 @@ InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *
 void InsertExecutor::Init() {
   auto *catalog = exec_ctx_->GetCatalog();
   table_info_ = catalog->GetTable(plan_->TableOid());
-  table_indexes_ = catalog->GetTableIndexes(table_info_->name_);
   if (child_executor_ != nullptr) {
     child_executor_->Init();
   }
@@ -30,10 +29,11 @@ void InsertExecutor::Init() {
 
 void InsertExecutor::InsertTableAndIndex(Tuple *tuple, RID *rid, Transaction *txn) {
   if (table_info_->table_->InsertTuple(*tuple, rid, txn)) {
-    for (const auto &index_info : table_indexes_) {
+    // 写完堆表再取索引列表: 之后注册的在线建索引扫描一定能看到这个元组
+    for (const auto &index_info : exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_)) {
       Index *index = index_info->index_.get();
       Tuple index_key(tuple->KeyFromTuple(table_info_->schema_, index_info->key_schema_, index->GetKeyAttrs()));
-      index->InsertEntry(index_key, *rid, txn);
+      index_info->InsertEntry(index_key, *rid, txn);
     }
     return;
   }
@@ -22,17 +22,19 @@ LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *pla
       emit_tuple_num_{0},
       skip_{false} {}
 
-void LimitExecutor::Init() { child_executor_->Init(); }
+void LimitExecutor::Init() {
+  child_executor_->Init();
+  emit_tuple_num_ = 0;
+  skip_ = false;
+}
 
 bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
   if (!skip_) {
     skip_ = true;
-    size_t i = 0;
-    while (child_executor_->Next(tuple, rid) && i < plan_->GetOffset()) {
-      i++;
-    }
-    if (i < plan_->GetOffset()) {
-      return false;
+    for (size_t i = 0; i < plan_->GetOffset(); i++) {
+      if (!child_executor_->Next(tuple, rid)) {
+        return false;
+      }
     }
   }
   if (emit_tuple_num_ < plan_->GetLimit()) {
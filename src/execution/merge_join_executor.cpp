@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+namespace bustub {
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_executor,
+                                     std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      left_(std::move(left_executor)),
+      right_(std::move(right_executor)),
+      left_valid_{},
+      right_valid_{},
+      output_pos_{} {}
+
+void MergeJoinExecutor::Init() {
+  left_->Init();
+  right_->Init();
+  run_.clear();
+  output_.clear();
+  output_pos_ = 0;
+  left_valid_ = Advance(true, &left_tuple_, &left_keys_);
+  right_valid_ = Advance(false, &right_tuple_, &right_keys_);
+}
+
+bool MergeJoinExecutor::Advance(bool left, Tuple *tuple, std::vector<Value> *keys) {
+  AbstractExecutor *child = left ? left_.get() : right_.get();
+  const auto &key_exprs = left ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+  const auto *schema = left ? plan_->GetLeftPlan()->OutputSchema() : plan_->GetRightPlan()->OutputSchema();
+  RID rid;
+  while (child->Next(tuple, &rid)) {
+    keys->clear();
+    for (const auto *key_expr : key_exprs) {
+      keys->push_back(key_expr->Evaluate(tuple, schema));
+      if (keys->back().IsNull()) {
+        break;
+      }
+    }
+    if (!keys->back().IsNull()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int MergeJoinExecutor::CompareKeys(const std::vector<Value> &a, const std::vector<Value> &b) {
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].CompareLessThan(b[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (a[i].CompareGreaterThan(b[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void MergeJoinExecutor::JoinRun() {
+  const auto *left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const auto *right_schema = plan_->GetRightPlan()->OutputSchema();
+  const auto *output_schema = plan_->OutputSchema();
+  const auto &output_columns = output_schema->GetColumns();
+  const auto *predicate = plan_->Predicate();
+  std::vector<Value> values(output_schema->GetColumnCount());
+  for (const auto &right_tuple : run_) {
+    if (nullptr != predicate &&
+        !predicate->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+      continue;
+    }
+    for (size_t k = 0; k < values.size(); ++k) {
+      values[k] = output_columns[k].GetExpr()->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema);
+    }
+    output_.emplace_back(values, output_schema);
+  }
+}
+
+bool MergeJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  while (output_pos_ == output_.size()) {
+    output_.clear();
+    output_pos_ = 0;
+    if (!left_valid_) {
+      return false;
+    }
+    if (!run_.empty() && CompareKeys(left_keys_, run_keys_) == 0) {
+      JoinRun();
+      left_valid_ = Advance(true, &left_tuple_, &left_keys_);
+      continue;
+    }
+    // 左边的键已经超过了当前的段, 在右边找下一个相等的段
+    run_.clear();
+    if (!right_valid_) {
+      return false;
+    }
+    int cmp = CompareKeys(left_keys_, right_keys_);
+    if (cmp < 0) {
+      left_valid_ = Advance(true, &left_tuple_, &left_keys_);
+    } else if (cmp > 0) {
+      right_valid_ = Advance(false, &right_tuple_, &right_keys_);
+    } else {
+      run_keys_ = right_keys_;
+      do {
+        run_.push_back(right_tuple_);
+        right_valid_ = Advance(false, &right_tuple_, &right_keys_);
+      } while (right_valid_ && CompareKeys(right_keys_, run_keys_) == 0);
+    }
+  }
+  *tuple = output_[output_pos_++];
+  return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,287 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_scheduler.cpp
+//
+// Identification: src/execution/morsel_scheduler.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "execution/executors/aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
+#include "execution/executors/sort_executor.h"
+
+namespace bustub {
+
+namespace {
+/** Hashes the join key of a tuple like HashJoinExecutor, @return false if a key is NULL. */
+bool HashKey(const Tuple &tuple, const std::vector<const AbstractExpression *> &keys, const Schema *schema,
+             hash_t *hash) {
+  hash_t curr_hash = 0;
+  for (const auto *key : keys) {
+    Value value = key->Evaluate(&tuple, schema);
+    if (value.IsNull()) {
+      return false;
+    }
+    curr_hash = HashUtil::CombineHashes(curr_hash, HashUtil::HashValue(&value));
+  }
+  *hash = curr_hash;
+  return true;
+}
+}  // namespace
+
+MorselScheduler::MorselScheduler(ExecutorContext *exec_ctx, size_t parallelism)
+    : exec_ctx_{exec_ctx}, parallelism_{std::max<size_t>(1, parallelism)} {}
+
+bool MorselScheduler::CanParallelize(const AbstractPlanNode *plan) {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan:
+      return true;
+    case PlanType::HashJoin:
+      return CanParallelize(plan->GetChildAt(0)) && CanParallelize(plan->GetChildAt(1));
+    case PlanType::Aggregation:
+    case PlanType::Sort:
+      return CanParallelize(plan->GetChildAt(0));
+    default:
+      return false;
+  }
+}
+
+void MorselScheduler::Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set) {
+  std::vector<std::vector<std::pair<uint64_t, Tuple>>> rows(parallelism_);
+  Produce(plan, [&](size_t worker, uint64_t order, const Tuple &tuple) {
+    if (nullptr != result_set) {
+      rows[worker].emplace_back(order, tuple);
+    }
+  });
+  if (nullptr == result_set) {
+    return;
+  }
+  std::vector<std::pair<uint64_t, Tuple>> all_rows;
+  for (auto &worker_rows : rows) {
+    all_rows.insert(all_rows.end(), worker_rows.begin(), worker_rows.end());
+    worker_rows.clear();
+  }
+  std::stable_sort(all_rows.begin(), all_rows.end(),
+                   [](const auto &a, const auto &b) { return a.first < b.first; });
+  for (const auto &row : all_rows) {
+    result_set->push_back(row.second);
+  }
+}
+
+void MorselScheduler::Produce(const AbstractPlanNode *plan, const Consumer &consume) {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan:
+      ProduceSeqScan(dynamic_cast<const SeqScanPlanNode *>(plan), consume);
+      break;
+    case PlanType::HashJoin:
+      ProduceHashJoin(dynamic_cast<const HashJoinPlanNode *>(plan), consume);
+      break;
+    case PlanType::Aggregation:
+      ProduceAggregation(dynamic_cast<const AggregationPlanNode *>(plan), consume);
+      break;
+    case PlanType::Sort:
+      ProduceSort(dynamic_cast<const SortPlanNode *>(plan), consume);
+      break;
+    default:
+      BUSTUB_ASSERT(false, "Plan type cannot run in parallel.");
+  }
+}
+
+void MorselScheduler::RunOnWorkers(const std::function<void(size_t worker)> &task) {
+  std::vector<std::exception_ptr> errors(parallelism_);
+  auto run = [&](size_t worker) {
+    try {
+      task(worker);
+    } catch (...) {
+      errors[worker] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t worker = 1; worker < parallelism_; ++worker) {
+    threads.emplace_back(run, worker);
+  }
+  run(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+/*****************************************************************************
+ * PIPELINES
+ *****************************************************************************/
+void MorselScheduler::ProduceSeqScan(const SeqScanPlanNode *plan, const Consumer &consume) {
+  TableMetadata *table_meta = exec_ctx_->GetCatalog()->GetTable(plan->GetTableOid());
+  auto page_ids = table_meta->table_->GetPageIds();
+  size_t num_morsels = (page_ids.size() + MORSEL_PAGES - 1) / MORSEL_PAGES;
+  std::atomic<size_t> next_morsel{0};
+  const auto *predicate = plan->GetPredicate();
+  const Schema *output_schema = plan->OutputSchema();
+  const auto &output_columns = output_schema->GetColumns();
+  RunOnWorkers([&](size_t worker) {
+    std::vector<Value> values(output_schema->GetColumnCount());
+    for (size_t morsel = next_morsel++; morsel < num_morsels; morsel = next_morsel++) {
+      // 按 (morsel, 序号) 排序即表序
+      uint64_t order = static_cast<uint64_t>(morsel) << 32U;
+      size_t end = std::min(page_ids.size(), (morsel + 1) * MORSEL_PAGES);
+      table_meta->table_->ScanPages(
+          page_ids, morsel * MORSEL_PAGES, end, exec_ctx_->GetTransaction(), [&](const Tuple &tuple) {
+            if (nullptr != predicate && !predicate->Evaluate(&tuple, &table_meta->schema_).GetAs<bool>()) {
+              return;
+            }
+            for (size_t i = 0; i < values.size(); ++i) {
+              values[i] = output_columns[i].GetExpr()->Evaluate(&tuple, &table_meta->schema_);
+            }
+            consume(worker, order++, Tuple(values, output_schema));
+          });
+    }
+  });
+}
+
+void MorselScheduler::ProduceHashJoin(const HashJoinPlanNode *plan, const Consumer &consume) {
+  const auto *left_schema = plan->GetLeftPlan()->OutputSchema();
+  const auto *right_schema = plan->GetRightPlan()->OutputSchema();
+  const auto *output_schema = plan->OutputSchema();
+  const auto &left_keys = plan->GetLeftKeys();
+  const auto &right_keys = plan->GetRightKeys();
+  const auto *predicate = plan->Predicate();
+
+  std::vector<std::vector<std::pair<Tuple, hash_t>>> build_tuples(parallelism_);
+  Produce(plan->GetRightPlan(), [&](size_t worker, uint64_t order, const Tuple &tuple) {
+    hash_t hash;
+    if (HashKey(tuple, right_keys, right_schema, &hash)) {
+      build_tuples[worker].emplace_back(tuple, hash);
+    }
+  });
+  JoinHashTable table;
+  for (auto &tuples : build_tuples) {
+    for (const auto &[tuple, hash] : tuples) {
+      table.Insert(tuple, hash);
+    }
+    tuples.clear();
+  }
+  table.Build();
+
+  // 建好的哈希表只读, 各线程并发探测
+  Produce(plan->GetLeftPlan(), [&](size_t worker, uint64_t order, const Tuple &left_tuple) {
+    hash_t hash;
+    if (!HashKey(left_tuple, left_keys, left_schema, &hash)) {
+      return;
+    }
+    table.Probe(hash, [&](const Tuple &right_tuple) {
+      for (size_t i = 0; i < left_keys.size(); ++i) {
+        Value left_value = left_keys[i]->Evaluate(&left_tuple, left_schema);
+        Value right_value = right_keys[i]->Evaluate(&right_tuple, right_schema);
+        if (left_value.CompareEquals(right_value) != CmpBool::CmpTrue) {
+          return;
+        }
+      }
+      if (nullptr != predicate &&
+          !predicate->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema).GetAs<bool>()) {
+        return;
+      }
+      std::vector<Value> values(output_schema->GetColumnCount());
+      const auto &output_columns = output_schema->GetColumns();
+      for (size_t k = 0; k < values.size(); ++k) {
+        values[k] = output_columns[k].GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple, right_schema);
+      }
+      consume(worker, order, Tuple(values, output_schema));
+    });
+  });
+}
+
+void MorselScheduler::ProduceAggregation(const AggregationPlanNode *plan, const Consumer &consume) {
+  const Schema *child_schema = plan->GetChildPlan()->OutputSchema();
+  std::vector<SimpleAggregationHashTable> tables;
+  tables.reserve(parallelism_);
+  for (size_t i = 0; i < parallelism_; ++i) {
+    tables.emplace_back(plan->GetAggregates(), plan->GetAggregateTypes());
+  }
+  Produce(plan->GetChildPlan(), [&](size_t worker, uint64_t order, const Tuple &tuple) {
+    AggregateKey key;
+    for (const auto *expr : plan->GetGroupBys()) {
+      key.group_bys_.emplace_back(expr->Evaluate(&tuple, child_schema));
+    }
+    AggregateValue val;
+    for (const auto *expr : plan->GetAggregates()) {
+      val.aggregates_.emplace_back(expr->Evaluate(&tuple, child_schema));
+    }
+    tables[worker].InsertCombine(key, val);
+  });
+  for (size_t i = 1; i < parallelism_; ++i) {
+    tables[0].Merge(tables[i]);
+  }
+
+  const auto *having = plan->GetHaving();
+  const Schema *output_schema = plan->OutputSchema();
+  const auto &output_columns = output_schema->GetColumns();
+  std::vector<Value> values(output_schema->GetColumnCount());
+  uint64_t order = 0;
+  for (auto iter = tables[0].Begin(); iter != tables[0].End(); ++iter) {
+    const auto &group_bys = iter.Key().group_bys_;
+    const auto &aggregates = iter.Val().aggregates_;
+    if (nullptr == having || having->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()) {
+      for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = output_columns[i].GetExpr()->EvaluateAggregate(group_bys, aggregates);
+      }
+      consume(0, order++, Tuple(values, output_schema));
+    }
+  }
+}
+
+void MorselScheduler::ProduceSort(const SortPlanNode *plan, const Consumer &consume) {
+  struct SortRow {
+    std::string key_;
+    uint64_t order_;
+    Tuple tuple_;
+  };
+  const Schema *child_schema = plan->GetChildPlan()->OutputSchema();
+  std::vector<std::vector<SortRow>> rows(parallelism_);
+  Produce(plan->GetChildPlan(), [&](size_t worker, uint64_t order, const Tuple &tuple) {
+    std::string key;
+    for (const auto &[order_by_type, expr] : plan->GetOrderBys()) {
+      SortExecutor::AppendSortKey(expr->Evaluate(&tuple, child_schema), order_by_type, &key);
+    }
+    rows[worker].push_back(SortRow{std::move(key), order, tuple});
+  });
+
+  // 键相同的按子计划的输出顺序, 与单线程的稳定排序一致
+  auto less = [](const SortRow &a, const SortRow &b) {
+    int cmp = a.key_.compare(b.key_);
+    return cmp < 0 || (cmp == 0 && a.order_ < b.order_);
+  };
+  RunOnWorkers([&](size_t worker) { std::sort(rows[worker].begin(), rows[worker].end(), less); });
+
+  std::vector<size_t> pos(parallelism_, 0);
+  auto beats = [&](size_t a, size_t b) {
+    bool a_valid = pos[a] < rows[a].size();
+    bool b_valid = pos[b] < rows[b].size();
+    if (!a_valid || !b_valid) {
+      return a_valid || (!b_valid && a < b);
+    }
+    return less(rows[a][pos[a]], rows[b][pos[b]]) || (!less(rows[b][pos[b]], rows[a][pos[a]]) && a < b);
+  };
+  LoserTree tree;
+  tree.Build(parallelism_, beats);
+  for (uint64_t order = 0; pos[tree.Top()] < rows[tree.Top()].size(); ++order) {
+    size_t top = tree.Top();
+    consume(0, order, rows[top][pos[top]++].tuple_);
+    tree.Replay(beats);
+  }
+}
+}  // namespace bustub
@@ -20,11 +20,13 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx),
       plan_{plan},
-      child_executor_(std::move(child_executor)) {}
+      child_executor_(std::move(child_executor)),
+      batch_cursor_(0) {}
 
 void NestIndexJoinExecutor::Init() {
   inner_table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetInnerTableOid());
   index_info_ = exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexName(), inner_table_info_->name_);
+  index_info_->WaitUntilReady();
   child_executor_->Init();
   const auto *comp_exp = dynamic_cast<const ComparisonExpression *>(plan_->Predicate());
   BUSTUB_ASSERT(comp_exp != nullptr, "NestIndexJoinExecutor: predicate should be a comparison exp");
@@ -38,6 +40,30 @@ void NestIndexJoinExecutor::Init() {
   BUSTUB_ASSERT(index_info_->key_schema_.GetColumnCount() == 1,
                 "NestIndexJoinExecutor: index schema should only have one column");
   outter_join_colidx_ = outter_child->GetColIdx();
+  batch_outer_tuples_.clear();
+  batch_outer_rids_.clear();
+  batch_inner_rids_.clear();
+  batch_cursor_ = 0;
+}
+
+bool NestIndexJoinExecutor::FetchBatch() {
+  batch_outer_tuples_.clear();
+  batch_outer_rids_.clear();
+  batch_cursor_ = 0;
+  Tuple tuple;
+  RID rid;
+  std::vector<Tuple> index_keys;
+  while (batch_outer_tuples_.size() < BATCH_TUPLES_NUM && child_executor_->Next(&tuple, &rid)) {
+    index_keys.emplace_back(std::vector<Value>{tuple.GetValue(plan_->OuterTableSchema(), outter_join_colidx_)},
+                            &index_info_->key_schema_);
+    batch_outer_tuples_.push_back(tuple);
+    batch_outer_rids_.push_back(rid);
+  }
+  if (batch_outer_tuples_.empty()) {
+    return false;
+  }
+  index_info_->index_->ScanKeys(index_keys, &batch_inner_rids_, exec_ctx_->GetTransaction());
+  return true;
 }
 
 bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
@@ -45,24 +71,25 @@ bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
   const auto *right_schema = plan_->InnerTableSchema();
   const auto *output_schema = plan_->OutputSchema();
   while (true) {
-    if (child_executor_->Next(tuple, rid)) {
-      Tuple index_key({tuple->GetValue(plan_->OuterTableSchema(), outter_join_colidx_)}, &index_info_->key_schema_);
-      std::vector<RID> result;
-      index_info_->index_->ScanKey(index_key, &result, exec_ctx_->GetTransaction());
-      if (!result.empty()) {
-        Tuple inner_tuple;
-        inner_table_info_->table_->GetTuple(result[0], &inner_tuple, exec_ctx_->GetTransaction());
-        std::vector<Value> values(output_schema->GetColumnCount());
-        const auto &output_columns = output_schema->GetColumns();
-        for (size_t k = 0; k < values.size(); ++k) {
-          values[k] = output_columns[k].GetExpr()->EvaluateJoin(tuple, left_schema, &inner_tuple, right_schema);
-        }
-        *tuple = Tuple(values, output_schema);
-        return true;
-      }
-    } else {
+    if (batch_cursor_ == batch_outer_tuples_.size() && !FetchBatch()) {
       return false;
     }
+    const Tuple &outer_tuple = batch_outer_tuples_[batch_cursor_];
+    const RID &outer_rid = batch_outer_rids_[batch_cursor_];
+    const auto &result = batch_inner_rids_[batch_cursor_];
+    ++batch_cursor_;
+    if (!result.empty()) {
+      Tuple inner_tuple;
+      inner_table_info_->table_->GetTuple(result[0], &inner_tuple, exec_ctx_->GetTransaction());
+      std::vector<Value> values(output_schema->GetColumnCount());
+      const auto &output_columns = output_schema->GetColumns();
+      for (size_t k = 0; k < values.size(); ++k) {
+        values[k] = output_columns[k].GetExpr()->EvaluateJoin(&outer_tuple, left_schema, &inner_tuple, right_schema);
+      }
+      *tuple = Tuple(values, output_schema);
+      *rid = outer_rid;
+      return true;
+    }
   }
 }
 }  // namespace bustub
@@ -11,15 +11,41 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/seq_scan_executor.h"
 
+#include "execution/expressions/column_value_expression.h"
+
 namespace bustub {
 
+namespace {
+void CollectColumns(const AbstractExpression *expr, std::vector<bool> *used) {
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr); nullptr != column) {
+    (*used)[column->GetColIdx()] = true;
+  }
+  for (const auto *child : expr->GetChildren()) {
+    CollectColumns(child, used);
+  }
+}
+}  // namespace
+
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
       plan_{plan},
       table_meta_{exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())},
       iter_(exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())->table_->Begin(exec_ctx->GetTransaction())),
       end_iter_(exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())->table_->End()),
-      predicate_{plan->GetPredicate()} {}
+      predicate_{plan->GetPredicate()} {
+  std::vector<bool> used(table_meta_->schema_.GetColumnCount());
+  if (nullptr != predicate_) {
+    CollectColumns(predicate_, &used);
+  }
+  for (const auto &column : plan_->OutputSchema()->GetColumns()) {
+    CollectColumns(column.GetExpr(), &used);
+  }
+  for (uint32_t i = 0; i < used.size(); ++i) {
+    if (used[i]) {
+      scan_column_idxs_.push_back(i);
+    }
+  }
+}
 
 void SeqScanExecutor::Init() {
   iter_ = table_meta_->table_->Begin(exec_ctx_->GetTransaction());
@@ -45,4 +71,31 @@ bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
   return false;
 }
 
+bool SeqScanExecutor::NextBatch(VectorBatch *batch) {
+  const Schema *table_schema = &table_meta_->schema_;
+  const Schema *output_schema = plan_->OutputSchema();
+  batch->Reset(output_schema->GetColumnCount());
+  std::vector<Value> selection;
+  do {
+    scan_batch_.Reset(table_schema->GetColumnCount());
+    for (; iter_ != end_iter_ && !scan_batch_.IsFull(); ++iter_) {
+      scan_batch_.AppendTuple(*iter_, table_schema, iter_->GetRid(), scan_column_idxs_);
+    }
+    if (scan_batch_.Size() == 0) {
+      return false;
+    }
+    if (nullptr != predicate_) {
+      predicate_->EvaluateBatch(scan_batch_, &selection);
+      scan_batch_.Filter(selection);
+    }
+  } while (scan_batch_.Size() == 0);
+
+  batch->GetRids() = scan_batch_.GetRids();
+  const auto &output_columns = output_schema->GetColumns();
+  for (uint32_t i = 0; i < output_columns.size(); ++i) {
+    output_columns[i].GetExpr()->EvaluateBatch(scan_batch_, &batch->GetColumn(i));
+  }
+  return true;
+}
+
 }  // namespace bustub
@@ -0,0 +1,287 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx), plan_{plan}, child_(std::move(child)), sorted_{}, entries_pos_{} {}
+
+SortExecutor::~SortExecutor() { DropRuns(); }
+
+void SortExecutor::Init() {
+  child_->Init();
+  sorted_ = false;
+  entries_.clear();
+  entries_pos_ = 0;
+  DropRuns();
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!sorted_) {
+    Sort();
+    sorted_ = true;
+  }
+  if (readers_.empty()) {
+    if (entries_pos_ == entries_.size()) {
+      return false;
+    }
+    *tuple = entries_[entries_pos_].tuple_;
+    *rid = entries_[entries_pos_++].rid_;
+  } else {
+    RunReader &reader = readers_[tree_.Top()];
+    if (!reader.valid_) {
+      return false;
+    }
+    *tuple = reader.head_.tuple_;
+    *rid = reader.head_.rid_;
+    Advance(&reader);
+    tree_.Replay([this](size_t a, size_t b) { return Beats(a, b); });
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * NORMALIZED KEYS
+ *****************************************************************************/
+namespace {
+template <typename T>
+void AppendBigEndian(T bits, std::string *key) {
+  for (int shift = 8 * (sizeof(T) - 1); shift >= 0; shift -= 8) {
+    key->push_back(static_cast<char>(bits >> shift));
+  }
+}
+}  // namespace
+
+void SortExecutor::AppendSortKey(const Value &value, OrderByType order_by_type, std::string *key) {
+  size_t begin = key->size();
+  if (value.IsNull()) {
+    // NULL 排在所有值之前
+    key->push_back(0);
+  } else {
+    key->push_back(1);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+        key->push_back(value.GetAs<int8_t>());
+        break;
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT: {
+        int64_t integer = value.CastAs(TypeId::BIGINT).GetAs<int64_t>();
+        // 翻转符号位, 负数的补码就按无符号序排在正数之前
+        AppendBigEndian(static_cast<uint64_t>(integer) ^ (uint64_t{1} << 63), key);
+        break;
+      }
+      case TypeId::DECIMAL: {
+        double decimal = value.GetAs<double>();
+        uint64_t bits;
+        std::memcpy(&bits, &decimal, sizeof(bits));
+        // 负数绝对值越大越小, 取反所有位; 非负数只翻转符号位
+        bits = (bits >> 63) != 0 ? ~bits : bits ^ (uint64_t{1} << 63);
+        AppendBigEndian(bits, key);
+        break;
+      }
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), key);
+        break;
+      case TypeId::VARCHAR: {
+        // 长度含结尾的 '\0'. 0x00 转义为 00 FF, 以 00 00 结束, 前缀就排在更长的串之前
+        const char *data = value.GetData();
+        uint32_t length = value.GetLength() == 0 ? 0 : value.GetLength() - 1;
+        for (uint32_t i = 0; i < length; ++i) {
+          key->push_back(data[i]);
+          if (data[i] == 0) {
+            key->push_back(static_cast<char>(0xFF));
+          }
+        }
+        key->push_back(0);
+        key->push_back(0);
+        break;
+      }
+      default:
+        throw Exception(ExceptionType::MISMATCH_TYPE, "cannot sort on this type");
+    }
+  }
+  if (order_by_type == OrderByType::DESC) {
+    for (size_t i = begin; i < key->size(); ++i) {
+      (*key)[i] = static_cast<char>(~(*key)[i]);
+    }
+  }
+}
+
+std::string SortExecutor::MakeKey(const Tuple &tuple) const {
+  std::string key;
+  for (const auto &[order_by_type, expr] : plan_->GetOrderBys()) {
+    AppendSortKey(expr->Evaluate(&tuple, child_->GetOutputSchema()), order_by_type, &key);
+  }
+  return key;
+}
+
+/*****************************************************************************
+ * RUN GENERATION
+ *****************************************************************************/
+void SortExecutor::Sort() {
+  size_t budget = exec_ctx_->GetMemoryBudget();
+  size_t bytes = 0;
+  Tuple tuple;
+  RID rid;
+  while (child_->Next(&tuple, &rid)) {
+    std::string key = MakeKey(tuple);
+    bytes += sizeof(SortEntry) + tuple.GetLength() + key.size();
+    entries_.push_back(SortEntry{std::move(key), tuple, rid});
+    if (budget != 0 && bytes > budget) {
+      WriteRun(&entries_);
+      bytes = 0;
+    }
+  }
+  if (runs_.empty()) {
+    std::stable_sort(entries_.begin(), entries_.end(),
+                     [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+    return;
+  }
+  if (!entries_.empty()) {
+    WriteRun(&entries_);
+  }
+
+  // 每趟把相邻的 MAX_FAN_IN 个 run 归并成一个, run 的先后不变, 排序才稳定
+  while (runs_.size() > MAX_FAN_IN) {
+    std::vector<Run> runs = std::move(runs_);
+    runs_.clear();
+    for (size_t begin = 0; begin < runs.size(); begin += MAX_FAN_IN) {
+      size_t end = std::min(runs.size(), begin + MAX_FAN_IN);
+      std::vector<Run> group(std::make_move_iterator(runs.begin() + begin),
+                             std::make_move_iterator(runs.begin() + end));
+      StartMerge(std::move(group));
+      Run merged;
+      TmpTuplePage *page = nullptr;
+      for (RunReader *reader = &readers_[tree_.Top()]; reader->valid_; reader = &readers_[tree_.Top()]) {
+        AppendToRun(reader->head_, &merged, &page);
+        Advance(reader);
+        tree_.Replay([this](size_t a, size_t b) { return Beats(a, b); });
+      }
+      if (nullptr != page) {
+        exec_ctx_->GetBufferPoolManager()->UnpinPage(page->GetTablePageId(), true);
+      }
+      readers_.clear();
+      runs_.push_back(std::move(merged));
+    }
+  }
+  std::vector<Run> runs = std::move(runs_);
+  runs_.clear();
+  StartMerge(std::move(runs));
+}
+
+void SortExecutor::WriteRun(std::vector<SortEntry> *entries) {
+  std::stable_sort(entries->begin(), entries->end(),
+                   [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+  Run run;
+  TmpTuplePage *page = nullptr;
+  for (const auto &entry : *entries) {
+    AppendToRun(entry, &run, &page);
+  }
+  if (nullptr != page) {
+    exec_ctx_->GetBufferPoolManager()->UnpinPage(page->GetTablePageId(), true);
+  }
+  entries->clear();
+  runs_.push_back(std::move(run));
+}
+
+void SortExecutor::AppendToRun(const SortEntry &entry, Run *run, TmpTuplePage **page) {
+  if (nullptr != *page && (*page)->Insert(entry.tuple_, entry.rid_)) {
+    return;
+  }
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  if (nullptr != *page) {
+    bpm->UnpinPage((*page)->GetTablePageId(), true);
+  }
+  page_id_t page_id;
+  *page = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+  if (nullptr == *page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  (*page)->Init(page_id, PAGE_SIZE);
+  run->push_back(page_id);
+  bool inserted = (*page)->Insert(entry.tuple_, entry.rid_);
+  BUSTUB_ASSERT(inserted, "A tuple must fit in an empty page.");
+}
+
+/*****************************************************************************
+ * MERGING
+ *****************************************************************************/
+void SortExecutor::StartMerge(std::vector<Run> &&runs) {
+  readers_.clear();
+  readers_.resize(runs.size());
+  for (size_t i = 0; i < runs.size(); ++i) {
+    readers_[i].run_ = std::move(runs[i]);
+    Advance(&readers_[i]);
+  }
+  tree_.Build(readers_.size(), [this](size_t a, size_t b) { return Beats(a, b); });
+}
+
+void SortExecutor::Advance(RunReader *reader) {
+  if (reader->pos_ == reader->tuples_.size()) {
+    reader->tuples_.clear();
+    reader->pos_ = 0;
+    if (reader->page_pos_ == reader->run_.size()) {
+      reader->valid_ = false;
+      return;
+    }
+    BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+    page_id_t page_id = reader->run_[reader->page_pos_++];
+    auto page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+    if (nullptr == page) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+    }
+    page->GetTuplesWithRids(&reader->tuples_);
+    bpm->UnpinPage(page_id, false);
+    bpm->DeletePage(page_id);
+    // GetTuples 按插入的逆序返回
+    std::reverse(reader->tuples_.begin(), reader->tuples_.end());
+  }
+  reader->head_.tuple_ = reader->tuples_[reader->pos_++];
+  reader->head_.rid_ = reader->head_.tuple_.GetRid();
+  reader->head_.key_ = MakeKey(reader->head_.tuple_);
+  reader->valid_ = true;
+}
+
+bool SortExecutor::Beats(size_t a, size_t b) const {
+  const RunReader &ra = readers_[a];
+  const RunReader &rb = readers_[b];
+  if (!ra.valid_ || !rb.valid_) {
+    return ra.valid_ || (!rb.valid_ && a < b);
+  }
+  int cmp = ra.head_.key_.compare(rb.head_.key_);
+  return cmp < 0 || (cmp == 0 && a < b);
+}
+
+void SortExecutor::DropRuns() {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  for (const auto &run : runs_) {
+    for (page_id_t page_id : run) {
+      bpm->DeletePage(page_id);
+    }
+  }
+  runs_.clear();
+  for (const auto &reader : readers_) {
+    for (size_t i = reader.page_pos_; i < reader.run_.size(); ++i) {
+      bpm->DeletePage(reader.run_[i]);
+    }
+  }
+  readers_.clear();
+}
+}  // namespace bustub
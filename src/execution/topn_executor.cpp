@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.cpp
+//
+// Identification: src/execution/topn_executor.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/topn_executor.h"
+
+#include <algorithm>
+
+#include "execution/executors/sort_executor.h"
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, size_t n,
+                           std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx), plan_{plan}, n_{n}, child_(std::move(child)), built_{}, pos_{} {}
+
+void TopNExecutor::Init() {
+  child_->Init();
+  built_ = false;
+  heap_.clear();
+  pos_ = 0;
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+  if (!built_) {
+    Build();
+    built_ = true;
+  }
+  if (pos_ == heap_.size()) {
+    return false;
+  }
+  *tuple = heap_[pos_].tuple_;
+  *rid = heap_[pos_++].rid_;
+  return true;
+}
+
+bool TopNExecutor::FitsInMemory(ExecutorContext *exec_ctx, const SortPlanNode *plan, size_t n) {
+  size_t budget = exec_ctx->GetMemoryBudget();
+  if (budget == 0) {
+    return true;
+  }
+  const Schema *schema = plan->GetChildPlan()->OutputSchema();
+  size_t tuple_length = schema->GetLength();
+  for (uint32_t column_idx : schema->GetUnlinedColumns()) {
+    tuple_length += schema->GetColumn(column_idx).GetVariableLength();
+  }
+  // 键由元组的列求值而来, 按与元组等长估计
+  size_t entry_bytes = sizeof(HeapEntry) + 2 * tuple_length;
+  return n <= budget / entry_bytes;
+}
+
+void TopNExecutor::Build() {
+  if (n_ == 0) {
+    return;
+  }
+  Tuple tuple;
+  RID rid;
+  std::string key;
+  for (size_t seq = 0; child_->Next(&tuple, &rid); ++seq) {
+    key.clear();
+    for (const auto &[order_by_type, expr] : plan_->GetOrderBys()) {
+      SortExecutor::AppendSortKey(expr->Evaluate(&tuple, child_->GetOutputSchema()), order_by_type, &key);
+    }
+    if (heap_.size() < n_) {
+      heap_.push_back(HeapEntry{key, seq, tuple, rid});
+      std::push_heap(heap_.begin(), heap_.end(), Less);
+      continue;
+    }
+    // seq 递增, 与堆顶键相等的元组排在它之后, 不必入堆
+    if (key.compare(heap_.front().key_) >= 0) {
+      continue;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), Less);
+    heap_.back().key_.swap(key);
+    heap_.back().seq_ = seq;
+    heap_.back().tuple_ = tuple;
+    heap_.back().rid_ = rid;
+    std::push_heap(heap_.begin(), heap_.end(), Less);
+  }
+  std::sort_heap(heap_.begin(), heap_.end(), Less);
+}
+}  // namespace bustub
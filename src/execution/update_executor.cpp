@@ -22,7 +22,6 @@ UpdateExecutor::UpdateExecutor(ExecutorContext *exec_ctx, const UpdatePlanNode *
 void UpdateExecutor::Init() {
   auto *catalog = exec_ctx_->GetCatalog();
   table_info_ = catalog->GetTable(plan_->TableOid());
-  table_indexes_ = catalog->GetTableIndexes(table_info_->name_);
   child_executor_->Init();
 }
 
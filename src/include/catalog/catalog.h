@@ -1,14 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <functional>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
 #include "storage/index/b_plus_tree_index.h"
+#include "storage/index/b_plus_tree_varlen_index.h"
 #include "storage/index/index.h"
 #include "storage/table/table_heap.h"
 
@@ -33,6 +41,22 @@ struct TableMetadata {
   table_oid_t oid_;
 };
 
+/**
+ * BUILDING: the index is being populated in the background, changes to it go to a side log
+ * READY: the index is complete and maintained directly
+ */
+enum class IndexState { BUILDING, READY };
+
+/**
+ * A change made to an index while it was being built, replayed when the initial load is done.
+ */
+struct IndexLogRecord {
+  IndexLogRecord(WType wtype, Tuple key, const RID &rid) : wtype_(wtype), key_(std::move(key)), rid_(rid) {}
+  WType wtype_;
+  Tuple key_;
+  RID rid_;
+};
+
 /**
  * Metadata about a index
  */
@@ -45,12 +69,92 @@ struct IndexInfo {
         index_oid_(index_oid),
         table_name_(std::move(table_name)),
         key_size_(key_size) {}
+
+  ~IndexInfo() {
+    if (build_thread_.joinable()) {
+      build_thread_.join();
+    }
+  }
+
+  /** Insert an entry, executors modify indexes through here so that a building index sees the change. */
+  void InsertEntry(const Tuple &key, const RID &rid, Transaction *txn) {
+    if (!LogIfBuilding(WType::INSERT, key, rid)) {
+      index_->InsertEntry(key, rid, txn);
+    }
+  }
+
+  /** Delete an entry, see InsertEntry. */
+  void DeleteEntry(const Tuple &key, const RID &rid, Transaction *txn) {
+    if (!LogIfBuilding(WType::DELETE, key, rid)) {
+      index_->DeleteEntry(key, rid, txn);
+    }
+  }
+
+  bool IsReady() const { return state_ == IndexState::READY; }
+
+  /** Block until a background build has finished, readers call this before using the index. */
+  void WaitUntilReady() {
+    if (IsReady()) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(side_log_latch_);
+    ready_cv_.wait(lock, [this] { return IsReady(); });
+  }
+
+  /**
+   * Replay the side log after the initial load. The latch is only held to swap the log out, the
+   * state flips to READY the first time the log is found empty.
+   */
+  void FinishBuild(Transaction *txn) {
+    std::vector<IndexLogRecord> records;
+    while (true) {
+      {
+        std::scoped_lock lock(side_log_latch_);
+        if (side_log_.empty()) {
+          state_ = IndexState::READY;
+          break;
+        }
+        records.swap(side_log_);
+      }
+      for (const auto &record : records) {
+        if (record.wtype_ == WType::INSERT) {
+          index_->InsertEntry(record.key_, record.rid_, txn);
+        } else {
+          index_->DeleteEntry(record.key_, record.rid_, txn);
+        }
+      }
+      records.clear();
+    }
+    ready_cv_.notify_all();
+  }
+
   Schema key_schema_;
   std::string name_;
   std::unique_ptr<Index> index_;
   index_oid_t index_oid_;
   std::string table_name_;
   const size_t key_size_;
+  std::atomic<IndexState> state_{IndexState::READY};
+  /** the background build of CreateIndexOnline, joined on destruction */
+  std::thread build_thread_;
+
+ private:
+  bool LogIfBuilding(WType wtype, const Tuple &key, const RID &rid) {
+    if (IsReady()) {
+      return false;
+    }
+    std::scoped_lock lock(side_log_latch_);
+    // 拿到锁之后再检查一次, FinishBuild 可能刚清空日志并切换状态
+    if (IsReady()) {
+      return false;
+    }
+    side_log_.emplace_back(wtype, key, rid);
+    return true;
+  }
+
+  std::mutex side_log_latch_;
+  std::condition_variable ready_cv_;
+  std::vector<IndexLogRecord> side_log_;
 };
 
 /**
@@ -115,67 +219,240 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param num_threads threads scanning the table and building the tree, 0 means one per core
    * @return a pointer to the metadata of the new table
+   * @note a key of a single INTEGER/BIGINT column is indexed by an IntegerKey tree regardless of KeyType,
+   * a key with a VARCHAR column by a VarlenBPlusTreeIndex
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
+                         size_t keysize, size_t num_threads = 0) {
     auto *table_meta = GetTable(table_name);
     auto index_meta_p = new IndexMetadata(index_name, table_name, &schema, key_attrs);
-    auto index_p = new BPLUSTREE_INDEX_TYPE(index_meta_p, bpm_);
-    auto end_iter = table_meta->table_->End();
-    for (auto iter = table_meta->table_->Begin(txn); iter != end_iter; ++iter) {
-      Tuple key(iter->KeyFromTuple(table_meta->schema_, key_schema, key_attrs));
-      index_p->InsertEntry(key, iter->GetRid(), txn);
+    Index *index_p = nullptr;
+    if (IsVarlenKey(*index_meta_p->GetKeySchema(), key_schema)) {
+      auto tree = new VarlenBPlusTreeIndex(index_meta_p, bpm_);
+      PopulateIndex(txn, table_meta, tree, key_schema, key_attrs, true);
+      index_p = tree;
+    } else {
+      DispatchKeyType<KeyType, ValueType, KeyComparator>(*index_meta_p->GetKeySchema(), [&](auto types) {
+        auto tree = NewBPlusTreeIndex(types, index_meta_p);
+        PopulateIndex(txn, table_meta, tree, key_schema, key_attrs, num_threads, true);
+        index_p = tree;
+      });
     }
     auto res =
         new IndexInfo(key_schema, index_name, std::unique_ptr<Index>(index_p), next_index_oid_++, table_name, keysize);
-    auto iter = index_names_.find(table_name);
-    if (iter == index_names_.end()) {
-      index_names_.insert(std::make_pair(table_name, std::unordered_map<std::string, index_oid_t>()));
-      iter = index_names_.find(table_name);
+    RegisterIndex(res);
+    return res;
+  }
+
+  /**
+   * Create a new index without blocking writers of the table. The index is registered right away
+   * in the BUILDING state; a background thread then loads the existing data, replays the log and
+   * marks the index READY. Writers look up the indexes of the table for every tuple after writing
+   * it to the heap, so a write either logs its change to the new index or is already in the heap
+   * when the initial scan starts, in-flight writers included.
+   * @return a pointer to the metadata of the new index, use WaitUntilReady() before reading it
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  IndexInfo *CreateIndexOnline(const std::string &index_name, const std::string &table_name, const Schema &schema,
+                               const Schema &key_schema, const std::vector<uint32_t> &key_attrs, size_t keysize,
+                               size_t num_threads = 0) {
+    auto *table_meta = GetTable(table_name);
+    auto index_meta_p = new IndexMetadata(index_name, table_name, &schema, key_attrs);
+    Index *index_p = nullptr;
+    std::function<void(Transaction *, const Schema &)> populate;
+    // 不加元组锁, 扫描期间的修改都在 side log 里, 最后重放
+    if (IsVarlenKey(*index_meta_p->GetKeySchema(), key_schema)) {
+      auto tree = new VarlenBPlusTreeIndex(index_meta_p, bpm_);
+      populate = [table_meta, tree, key_attrs](Transaction *txn, const Schema &index_key_schema) {
+        PopulateIndex(txn, table_meta, tree, index_key_schema, key_attrs, false);
+      };
+      index_p = tree;
+    } else {
+      DispatchKeyType<KeyType, ValueType, KeyComparator>(*index_meta_p->GetKeySchema(), [&](auto types) {
+        auto tree = NewBPlusTreeIndex(types, index_meta_p);
+        populate = [table_meta, tree, key_attrs, num_threads](Transaction *txn, const Schema &index_key_schema) {
+          PopulateIndex(txn, table_meta, tree, index_key_schema, key_attrs, num_threads, false);
+        };
+        index_p = tree;
+      });
     }
-    auto &name2oid = iter->second;
-    BUSTUB_ASSERT(name2oid.count(index_name) == 0, "index names should be unique!");
-    name2oid.insert(std::make_pair(index_name, res->index_oid_));
-    indexes_.insert(std::make_pair(res->index_oid_, std::unique_ptr<IndexInfo>(res)));
+    auto res =
+        new IndexInfo(key_schema, index_name, std::unique_ptr<Index>(index_p), next_index_oid_++, table_name, keysize);
+    res->state_ = IndexState::BUILDING;
+    RegisterIndex(res);
+    res->build_thread_ = std::thread([res, populate] {
+      Transaction txn(INVALID_TXN_ID);
+      populate(&txn, res->key_schema_);
+      res->FinishBuild(&txn);
+    });
     return res;
   }
 
   IndexInfo *GetIndex(const std::string &index_name, const std::string &table_name) {
+    index_latch_.RLock();
+    IndexInfo *res = nullptr;
     auto iter1 = index_names_.find(table_name);
     if (iter1 != index_names_.end()) {
       const auto &name2oid = iter1->second;
       auto iter2 = name2oid.find(index_name);
       if (iter2 != name2oid.end()) {
-        return GetIndex(iter2->second);
+        res = GetIndexUnlocked(iter2->second);
       }
     }
-    return nullptr;
+    index_latch_.RUnlock();
+    return res;
   }
 
   IndexInfo *GetIndex(index_oid_t index_oid) {
-    auto iter = indexes_.find(index_oid);
-    if (iter != indexes_.end()) {
-      return iter->second.get();
-    }
-    return nullptr;
+    index_latch_.RLock();
+    IndexInfo *res = GetIndexUnlocked(index_oid);
+    index_latch_.RUnlock();
+    return res;
   }
 
+  /**
+   * @return all indexes of the table, including ones still being built, which writers have to maintain too;
+   * writers call this per tuple, after the heap write, so that they see indexes created while they run
+   */
   std::vector<IndexInfo *> GetTableIndexes(const std::string &table_name) {
     std::vector<IndexInfo *> table_indexes;
+    index_latch_.RLock();
     auto iter1 = index_names_.find(table_name);
     if (iter1 != index_names_.end()) {
       const auto &name2oid = iter1->second;
       for (const auto &elem : name2oid) {
-        table_indexes.push_back(GetIndex(elem.second));
+        table_indexes.push_back(GetIndexUnlocked(elem.second));
       }
     }
+    index_latch_.RUnlock();
     return table_indexes;
   }
 
  private:
+  /** Carries the template arguments of a BPlusTreeIndex through a generic lambda */
+  template <class KeyType, class ValueType, class KeyComparator>
+  struct IndexTypes {};
+
+  /**
+   * Call fn with the IndexTypes the index is built with. Single INTEGER/BIGINT keys get an IntegerKey
+   * tree, which compares native integers instead of going through the key schema; everything else
+   * keeps the requested types.
+   */
+  template <class KeyType, class ValueType, class KeyComparator, typename F>
+  static void DispatchKeyType(const Schema &index_key_schema, F &&fn) {
+    switch (IntegerKeyType(index_key_schema)) {
+      case TypeId::INTEGER:
+        fn(IndexTypes<IntegerKey<int32_t>, ValueType, IntegerComparator<int32_t>>{});
+        break;
+      case TypeId::BIGINT:
+        fn(IndexTypes<IntegerKey<int64_t>, ValueType, IntegerComparator<int64_t>>{});
+        break;
+      default:
+        fn(IndexTypes<KeyType, ValueType, KeyComparator>{});
+        break;
+    }
+  }
+
+  template <class KeyType, class ValueType, class KeyComparator>
+  BPLUSTREE_INDEX_TYPE *NewBPlusTreeIndex(IndexTypes<KeyType, ValueType, KeyComparator> /*types*/,
+                                          IndexMetadata *index_meta_p) {
+    return new BPLUSTREE_INDEX_TYPE(index_meta_p, bpm_);
+  }
+
+  /**
+   * Scan the table in page ranges, one thread per range, and bulk load the collected keys.
+   * @param lock_tuples false skips tuple locks, used by the online build
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  static void PopulateIndex(Transaction *txn, TableMetadata *table_meta, BPLUSTREE_INDEX_TYPE *index_p,
+                            const Schema &key_schema, const std::vector<uint32_t> &key_attrs, size_t num_threads,
+                            bool lock_tuples) {
+    if (num_threads == 0) {
+      num_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    if (enable_logging && lock_tuples) {
+      // GetTuple 会给元组加共享锁, 事务的锁集合不是线程安全的
+      num_threads = 1;
+    }
+    // 每个线程扫描一段连续的表页, 得到一个未排序的 run
+    auto page_ids = table_meta->table_->GetPageIds();
+    num_threads = std::max<size_t>(1, std::min(num_threads, page_ids.size()));
+    std::vector<std::vector<std::pair<KeyType, ValueType>>> runs(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads.emplace_back([&, i] {
+        size_t begin = page_ids.size() * i / num_threads;
+        size_t end = page_ids.size() * (i + 1) / num_threads;
+        table_meta->table_->ScanPages(
+            page_ids, begin, end, txn,
+            [&](const Tuple &tuple) {
+              KeyType key;
+              key.SetFromKey(tuple.KeyFromTuple(table_meta->schema_, key_schema, key_attrs));
+              runs[i].emplace_back(key, tuple.GetRid());
+            },
+            lock_tuples);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    index_p->BulkLoad(&runs, num_threads, txn);
+  }
+
+  /**
+   * @return true if the key has a VARCHAR column and key tuples are laid out like index_key_schema, such
+   * keys are indexed by VarlenBPlusTreeIndex, which stores them with the bytes they need
+   */
+  static bool IsVarlenKey(const Schema &index_key_schema, const Schema &key_schema) {
+    if (index_key_schema.IsInlined() || index_key_schema.GetColumnCount() != key_schema.GetColumnCount()) {
+      return false;
+    }
+    for (uint32_t i = 0; i < key_schema.GetColumnCount(); ++i) {
+      if (index_key_schema.GetColumn(i).GetType() != key_schema.GetColumn(i).GetType()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Insert the keys of the table one by one, the variable length tree has no bulk load. */
+  static void PopulateIndex(Transaction *txn, TableMetadata *table_meta, Index *index_p, const Schema &key_schema,
+                            const std::vector<uint32_t> &key_attrs, bool lock_tuples) {
+    auto page_ids = table_meta->table_->GetPageIds();
+    table_meta->table_->ScanPages(
+        page_ids, 0, page_ids.size(), txn,
+        [&](const Tuple &tuple) {
+          index_p->InsertEntry(tuple.KeyFromTuple(table_meta->schema_, key_schema, key_attrs), tuple.GetRid(), txn);
+        },
+        lock_tuples);
+  }
+
+  void RegisterIndex(IndexInfo *res) {
+    index_latch_.WLock();
+    auto iter = index_names_.find(res->table_name_);
+    if (iter == index_names_.end()) {
+      index_names_.insert(std::make_pair(res->table_name_, std::unordered_map<std::string, index_oid_t>()));
+      iter = index_names_.find(res->table_name_);
+    }
+    auto &name2oid = iter->second;
+    BUSTUB_ASSERT(name2oid.count(res->name_) == 0, "index names should be unique!");
+    name2oid.insert(std::make_pair(res->name_, res->index_oid_));
+    indexes_.insert(std::make_pair(res->index_oid_, std::unique_ptr<IndexInfo>(res)));
+    index_latch_.WUnlock();
+  }
+
+  IndexInfo *GetIndexUnlocked(index_oid_t index_oid) {
+    auto iter = indexes_.find(index_oid);
+    if (iter != indexes_.end()) {
+      return iter->second.get();
+    }
+    return nullptr;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -190,6 +467,8 @@ class Catalog {
   std::unordered_map<index_oid_t, std::unique_ptr<IndexInfo>> indexes_;
   /** index_names_: table name -> index names -> index identifiers */
   std::unordered_map<std::string, std::unordered_map<std::string, index_oid_t>> index_names_;
+  /** index_latch_ guards indexes_ and index_names_, indexes are created while executors run */
+  ReaderWriterLatch index_latch_;
   /** The next index identifier to be used */
   std::atomic<index_oid_t> next_index_oid_{0};
 };
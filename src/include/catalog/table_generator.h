@@ -25,6 +25,12 @@ class TableGenerator {
    */
   void GenerateTestTables();
 
+  /**
+   * Generate a table for benchmarks: colA is serial, colB uniform in [0, 9] and
+   * colC uniform in [0, num_rows), so colC has duplicates.
+   */
+  void GenerateBenchmarkTable(const char *name, uint32_t num_rows);
+
  private:
   /**
    * Enumeration to characterize the distribution of values in a given column
@@ -97,6 +103,8 @@ class TableGenerator {
         : name_(name), num_rows_(num_rows), col_meta_(std::move(col_meta)) {}
   };
 
+  void CreateTable(TableInsertMeta *table_meta);
+
   void FillTable(TableMetadata *info, TableInsertMeta *table_meta);
 
   std::vector<Value> MakeValues(ColumnInsertMeta *col_meta, uint32_t count);
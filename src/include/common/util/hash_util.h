@@ -13,7 +13,9 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -28,23 +30,54 @@ class HashUtil {
  private:
   static const hash_t prime_factor = 10000019;
 
+  // xxHash64 primes
+  static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+  static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+  static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+
+  static inline uint64_t RotateLeft(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+  static inline uint64_t Round(uint64_t hash, uint64_t word) {
+    hash ^= RotateLeft(word * PRIME2, 31) * PRIME1;
+    return RotateLeft(hash, 27) * PRIME1 + PRIME3;
+  }
+
  public:
-  static inline hash_t HashBytes(const char *bytes, size_t length) {
-    // https://github.com/greenplum-db/gpos/blob/b53c1acd6285de94044ff91fbee91589543feba1/libgpos/src/utils.cpp#L126
-    hash_t hash = length;
-    for (size_t i = 0; i < length; ++i) {
-      hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
-    }
+  /** murmur3 fmix64, a bijection whose every output bit depends on every input bit */
+  static inline hash_t Mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
     return hash;
   }
 
-  static inline hash_t CombineHashes(hash_t l, hash_t r) {
-    hash_t both[2];
-    both[0] = l;
-    both[1] = r;
-    return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
+  /**
+   * Hashes 8 bytes at a time with the xxHash64 round and finishes with Mix, so
+   * keys that differ in any byte, high or low, spread over all 64 bits.
+   */
+  static inline hash_t HashBytes(const char *bytes, size_t length) {
+    uint64_t hash = PRIME3 + length * PRIME1;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(uint64_t));
+      hash = Round(hash, word);
+    }
+    if (i < length) {
+      uint64_t word = 0;
+      memcpy(&word, bytes + i, length - i);
+      hash = Round(hash, word);
+    }
+    return Mix(hash);
   }
 
+  /** @return the hash of an integer, one Mix; distinct integers never collide */
+  static inline hash_t HashInt(uint64_t val) { return Mix(val + PRIME3); }
+
+  static inline hash_t CombineHashes(hash_t l, hash_t r) { return Mix(Round(l, r)); }
+
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % prime_factor + r % prime_factor) % prime_factor; }
 
   template <typename T>
@@ -61,24 +94,19 @@ class HashUtil {
   static inline hash_t HashValue(const Value *val) {
     switch (val->GetTypeId()) {
       case TypeId::TINYINT: {
-        auto raw = static_cast<int64_t>(val->GetAs<int8_t>());
-        return Hash<int64_t>(&raw);
+        return HashInt(static_cast<int64_t>(val->GetAs<int8_t>()));
       }
       case TypeId::SMALLINT: {
-        auto raw = static_cast<int64_t>(val->GetAs<int16_t>());
-        return Hash<int64_t>(&raw);
+        return HashInt(static_cast<int64_t>(val->GetAs<int16_t>()));
       }
       case TypeId::INTEGER: {
-        auto raw = static_cast<int64_t>(val->GetAs<int32_t>());
-        return Hash<int64_t>(&raw);
+        return HashInt(static_cast<int64_t>(val->GetAs<int32_t>()));
       }
       case TypeId::BIGINT: {
-        auto raw = static_cast<int64_t>(val->GetAs<int64_t>());
-        return Hash<int64_t>(&raw);
+        return HashInt(static_cast<int64_t>(val->GetAs<int64_t>()));
       }
       case TypeId::BOOLEAN: {
-        auto raw = val->GetAs<bool>();
-        return Hash<bool>(&raw);
+        return HashInt(static_cast<uint64_t>(val->GetAs<bool>()));
       }
       case TypeId::DECIMAL: {
         auto raw = val->GetAs<double>();
@@ -90,8 +118,7 @@ class HashUtil {
         return HashBytes(raw, len);
       }
       case TypeId::TIMESTAMP: {
-        auto raw = val->GetAs<uint64_t>();
-        return Hash<uint64_t>(&raw);
+        return HashInt(val->GetAs<uint64_t>());
       }
       default: {
         BUSTUB_ASSERT(false, "Unsupported type.");
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete.
+ *
+ * A directory page maps the low global depth bits of a hash to a bucket page,
+ * so a lookup fetches two pages. A full bucket is split in two, doubling the
+ * directory only when its local depth reaches the global depth; an emptied
+ * bucket is merged back into its split image and the directory shrinks when it
+ * can. Growth therefore never rehashes more than one bucket.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable with one empty bucket
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists or its bucket can't be split any more
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Checks that every directory slot agrees with its bucket: slots sharing a bucket have the
+   * same local depth, each bucket is shared by 1 << (global depth - local depth) slots, and
+   * every key of a bucket hashes to it. For tests.
+   */
+  void VerifyIntegrity();
+
+ private:
+  using HashTableBucket = HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+  uint32_t Hash(const KeyType &key) { return static_cast<uint32_t>(hash_fn_.GetHash(key)); }
+
+  HashTableDirectoryPage *FetchDirectoryPage();
+
+  Page *FetchBucketPage(page_id_t bucket_page_id);
+
+  // insert after splitting the bucket of key until the pair fits, with table_latch_ write latched
+  bool SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value);
+
+  // merge the bucket of key into its split image if it is empty, with table_latch_ write latched
+  void Merge(Transaction *transaction, const KeyType &key);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes inserts and removes that stay within a bucket, writer splits and merges buckets
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +33,12 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * Growing is incremental: Resize only allocates a table twice as large under
+ * the write latch, inserts go to the new table from then on, and every insert
+ * and remove moves one block of the old table over. Until the old table is
+ * drained lookups and removes search it first and the new table second, so a
+ * pair moved in between is still found.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -87,16 +94,67 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   size_t GetSize();
 
  private:
+  using HashTableBlock = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  enum class InsertResult { INSERTED, DUPLICATE, FULL };
+
+  // allocate a table of at least num_buckets slots, returns the page id of its header
+  page_id_t CreateTable(size_t num_buckets);
+
+  void DeleteTable(page_id_t header_page_id);
+
+  /**
+   * Walk the slots of a table from the home slot of hash, latching one block at a
+   * time, a tag group of the block at a time. visit(block, group_ind, live, empty) gets the
+   * slots of the group on the walk that come before the first never occupied one as bits of
+   * live, and that slot as the single bit of empty (0 if there is none). The walk ends once
+   * visit returns true, empty is set or every slot was visited.
+   * @return true if visit stopped the walk
+   */
+  template <typename Visit>
+  bool Probe(page_id_t header_page_id, uint64_t hash, bool exclusive, Visit &&visit);
+
+  void GetValueIn(page_id_t header_page_id, const KeyType &key, uint64_t hash, std::vector<ValueType> *result);
+
+  bool Contains(page_id_t header_page_id, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  // pairs only go to never occupied slots, so two inserts of the same pair meet on the same slot
+  InsertResult InsertInto(page_id_t header_page_id, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  bool RemoveFrom(page_id_t header_page_id, const KeyType &key, uint64_t hash, const ValueType &value);
+
+  // move the pairs of one block of the old table to the current table, call it with table_latch_ held
+  void MigrateBlock(size_t block_index);
+
+  // move one block of the old table if a resize is in progress, and drop the old table after the last one
+  void MigrateStep();
+
+  // move the blocks no one has taken yet and drop the old table, call it with table_latch_ write latched
+  void FinishMigration();
+
   // member variable
   page_id_t header_page_id_;
+  // slots of the current table
+  size_t size_;
+  // table being drained into the current one, INVALID_PAGE_ID when no resize is in progress
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  size_t old_num_blocks_{0};
+  // next block of the old table to migrate and the number of blocks migrated
+  std::atomic<size_t> next_migrate_block_{0};
+  std::atomic<size_t> migrated_blocks_{0};
+  // occupied slots of the current table, tombstones included
+  std::atomic<size_t> num_occupied_{0};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers includes inserts, removes and migrating a block, writer is only resize and dropping the old table
   ReaderWriterLatch table_latch_;
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
+
+  // the table grows once this share of its slots is occupied, probe sequences get long beyond it
+  static constexpr double MAX_LOAD_FACTOR = 0.75;
 };
 
 }  // namespace bustub
@@ -19,6 +19,8 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
+#include "execution/morsel_scheduler.h"
+#include "execution/vector_batch.h"
 #include "execution/plans/abstract_plan.h"
 #include "storage/table/tuple.h"
 namespace bustub {
@@ -31,6 +33,18 @@ class ExecutionEngine {
 
   bool Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) {
+    // 加锁的事务的锁集合不是线程安全的; 并行执行的流水线断点不会溢出到磁盘
+    if (exec_ctx->GetParallelism() > 1 && !enable_logging && exec_ctx->GetMemoryBudget() == 0 &&
+        MorselScheduler::CanParallelize(plan)) {
+      // 工作线程抛出的异常由 MorselScheduler 在汇合后重新抛出
+      try {
+        MorselScheduler(exec_ctx, exec_ctx->GetParallelism()).Execute(plan, result_set);
+      } catch (Exception &e) {
+        return false;
+      }
+      return true;
+    }
+
     // construct executor
     auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
@@ -53,6 +67,31 @@ class ExecutionEngine {
     return true;
   }
 
+  /**
+   * Executes a query plan like Execute, pulling VectorBatches from the root executor
+   * with NextBatch instead of one tuple at a time.
+   * @return false if an executor threw an Exception, true otherwise
+   */
+  bool ExecuteBatch(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
+                    ExecutorContext *exec_ctx) {
+    auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+    executor->Init();
+    try {
+      VectorBatch batch;
+      while (executor->NextBatch(&batch)) {
+        if (result_set != nullptr) {
+          for (size_t i = 0; i < batch.Size(); ++i) {
+            result_set->push_back(batch.GetTuple(i, executor->GetOutputSchema()));
+          }
+        }
+      }
+    } catch (Exception &e) {
+      return false;
+    }
+
+    return true;
+  }
+
  private:
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] TransactionManager *txn_mgr_;
@@ -54,10 +54,22 @@ class ExecutorContext {
   /** @return the lock manager - don't worry about it for now */
   LockManager *GetLockManager() { return nullptr; }
 
+  /** @return the bytes an operator of the query may hold in memory before spilling to TmpTuplePages, 0 if unlimited */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  /** @return the number of threads ExecutionEngine may run the query on, 1 for the calling thread only */
+  size_t GetParallelism() const { return parallelism_; }
+
+  void SetParallelism(size_t parallelism) { parallelism_ = parallelism; }
+
  private:
   Transaction *transaction_;
   Catalog *catalog_;
   BufferPoolManager *bpm_;
+  size_t memory_budget_{0};
+  size_t parallelism_{1};
 };
 
 }  // namespace bustub
@@ -13,11 +13,17 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/vector_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
- * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * AbstractExecutor implements the Volcano tuple-at-a-time iterator model, and its
+ * vectorized form where NextBatch produces a VectorBatch of rows per call.
+ *
+ * Every executor implements Next. NextBatch falls back to calling Next for a batch
+ * worth of tuples; executors that gain from working on whole batches override it. A
+ * parent may read some tuples with Next and then switch to NextBatch, but not back.
  */
 class AbstractExecutor {
  public:
@@ -44,6 +50,22 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next batch of rows from this executor.
+   * @param[out] batch the next rows, with the columns of the output schema
+   * @return true if the batch has rows, false if there are no more rows
+   */
+  virtual bool NextBatch(VectorBatch *batch) {
+    const Schema *schema = GetOutputSchema();
+    batch->Reset(nullptr == schema ? 0 : schema->GetColumnCount());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, schema, rid);
+    }
+    return batch->Size() > 0;
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
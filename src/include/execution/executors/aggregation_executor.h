@@ -103,6 +103,36 @@ class SimpleAggregationHashTable {
     CombineAggregateValues(&ht[agg_key], agg_val);
   }
 
+  /**
+   * Merges the groups of another table over the same aggregates into this one, combining
+   * the partial aggregates of groups in both: counts and sums add up, mins and maxes compare.
+   * @param other the table to merge, e.g. one that aggregated another part of the input
+   */
+  void Merge(const SimpleAggregationHashTable &other) {
+    for (const auto &[agg_key, agg_val] : other.ht) {
+      auto iter = ht.find(agg_key);
+      if (iter == ht.end()) {
+        ht.insert({agg_key, agg_val});
+        continue;
+      }
+      auto &result = iter->second.aggregates_;
+      for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+        switch (agg_types_[i]) {
+          case AggregationType::CountAggregate:
+          case AggregationType::SumAggregate:
+            result[i] = result[i].Add(agg_val.aggregates_[i]);
+            break;
+          case AggregationType::MinAggregate:
+            result[i] = result[i].Min(agg_val.aggregates_[i]);
+            break;
+          case AggregationType::MaxAggregate:
+            result[i] = result[i].Max(agg_val.aggregates_[i]);
+            break;
+        }
+      }
+    }
+  }
+
   /**
    * An iterator through the simplified aggregation hash table.
    */
@@ -172,6 +202,9 @@ class AggregationExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /** Aggregates the child a batch at a time, evaluating the group bys and aggregates per batch. */
+  bool NextBatch(VectorBatch *batch) override;
+
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -199,6 +232,11 @@ class AggregationExecutor : public AbstractExecutor {
   SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator. */
   SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** true once the child has been aggregated */
+  bool aggregated_;
   std::vector<Tuple> output_;
+
+  /** Fills output_ with the groups that pass the having clause. */
+  void BuildOutput();
 };
 }  // namespace bustub
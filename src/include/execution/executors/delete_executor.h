@@ -53,7 +53,5 @@ class DeleteExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> child_executor_;
   /** Metadata identifying the table that should be delete. */
   const TableMetadata *table_info_;
-
-  std::vector<IndexInfo *> table_indexes_;
 };
 }  // namespace bustub
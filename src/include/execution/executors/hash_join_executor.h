@@ -0,0 +1,236 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * In memory hash table over the build side tuples of a hash join. The tuples are
+ * added first and the table is then built once, with its size known, as a linear
+ * probing array of (hash, tuple index) slots: a probe compares full 64 bit hashes
+ * in consecutive slots and only touches the tuples whose hash matches.
+ */
+class JoinHashTable {
+ public:
+  /** Adds a tuple whose join key hashes to hash, call it before Build. */
+  void Insert(const Tuple &tuple, hash_t hash) {
+    tuples_.push_back(tuple);
+    hashes_.push_back(hash);
+  }
+
+  /** Places the added tuples in a slot array at most half full. */
+  void Build() {
+    size_t capacity = 2;
+    while (capacity < 2 * tuples_.size()) {
+      capacity <<= 1;
+    }
+    slots_.assign(capacity, Slot{0, 0});
+    for (uint32_t i = 0; i < tuples_.size(); i++) {
+      size_t slot = hashes_[i] & (capacity - 1);
+      while (slots_[slot].index_ != 0) {
+        slot = (slot + 1) & (capacity - 1);
+      }
+      slots_[slot] = Slot{hashes_[i], i + 1};
+    }
+    hashes_.clear();
+    hashes_.shrink_to_fit();
+  }
+
+  /** Calls match(tuple) for every tuple added with the given hash, and maybe a few more. */
+  template <typename Match>
+  void Probe(hash_t hash, Match &&match) const {
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = hash & mask; slots_[slot].index_ != 0; slot = (slot + 1) & mask) {
+      if (slots_[slot].hash_ == hash) {
+        match(tuples_[slots_[slot].index_ - 1]);
+      }
+    }
+  }
+
+  size_t Size() const { return tuples_.size(); }
+
+  void Clear() {
+    tuples_.clear();
+    hashes_.clear();
+    slots_.clear();
+  }
+
+ private:
+  struct Slot {
+    hash_t hash_;
+    /** 1 + the index of the tuple in tuples_, 0 if the slot is empty */
+    uint32_t index_;
+  };
+
+  std::vector<Tuple> tuples_;
+  /** hashes of tuples_ until Build */
+  std::vector<hash_t> hashes_;
+  std::vector<Slot> slots_;
+};
+
+/**
+ * HashJoinExecutor executes an equi-join by building a JoinHashTable on one child
+ * and probing it with the tuples of the other.
+ *
+ * Child sizes are unknown up front, so both children are read a block at a time in
+ * turn until one of them runs out; that one is the smaller and becomes the build
+ * side. The tuples already read from the other side are probed first, then the rest
+ * of it is streamed.
+ *
+ * If the tuples read exceed the memory budget of the ExecutorContext first, the join
+ * turns into a grace hash join: both children are split by key hash into
+ * NUM_PARTITIONS partitions written to TmpTuplePages, and each pair of partitions is
+ * joined in memory, building on the smaller one. A build partition still over the
+ * budget is split again with other hash bits, up to MAX_LEVELS times; past that its
+ * keys are too skewed to split and it is joined in memory regardless.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor that produces tuple for the left side of join
+   * @param right_executor the child executor that produces tuple for the right side of join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  ~HashJoinExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Probes the table with a batch of probe side rows at a time and evaluates the key
+   * checks, the predicate and the output columns over all matches of the batch at once.
+   */
+  bool NextBatch(VectorBatch *batch) override;
+
+ private:
+  /** The tuples of one side of the join whose keys hash to the same partition, on TmpTuplePages. */
+  struct Partition {
+    std::vector<page_id_t> pages_;
+    size_t bytes_{0};
+  };
+
+  struct PartitionPair {
+    Partition left_;
+    Partition right_;
+    /** number of times the tuples were split */
+    uint32_t level_;
+  };
+
+  /** @return the memory a tuple takes in the hash table, for the budget */
+  static size_t TupleBytes(const Tuple &tuple) { return sizeof(Tuple) + tuple.GetLength(); }
+
+  /** Reads up to BLOCK_TUPLES_NUM tuples of child into tuples, @return false if child ran out. */
+  static bool FetchBlock(AbstractExecutor *child, std::vector<Tuple> *tuples, size_t *bytes);
+
+  /** Hashes the join key of a tuple of the left (or right) child, @return false if a key is NULL. */
+  bool HashKey(const Tuple &tuple, bool left, hash_t *hash) const;
+
+  /** Picks the build side, builds the table and buffers the probe tuples read so far, or spills. */
+  void Build();
+
+  /** Partitions the tuples read so far and the rest of both children. */
+  void Spill(std::vector<Tuple> *left_tuples, bool left_more, std::vector<Tuple> *right_tuples, bool right_more);
+
+  /**
+   * Writes the tuples of one side that next(&tuple) yields until it returns false to
+   * NUM_PARTITIONS partitions, split by the hash bits of level. Tuples with NULL keys are dropped.
+   */
+  template <typename Source>
+  std::vector<Partition> PartitionTuples(bool left, uint32_t level, Source &&next);
+
+  /** Splits a partition again at level, deleting its pages. */
+  std::vector<Partition> Repartition(Partition *partition, bool left, uint32_t level);
+
+  /** Appends the tuples of a partition page to tuples and deletes the page. */
+  void ReadPartitionPage(page_id_t page_id, std::vector<Tuple> *tuples);
+
+  void DropPartition(Partition *partition);
+
+  /** Deletes the pages of the partitions not joined yet. */
+  void DropSpilledPages();
+
+  /** Builds the table on the next pair of partitions that can join, @return false if there is none left. */
+  bool NextPartitionPair();
+
+  /** @return the next tuple of the probe side, false if there is none left. */
+  bool NextProbeTuple(Tuple *tuple, RID *rid);
+
+  /** Adds the join results of one probe side tuple to output_. */
+  void ProbeTuple(const Tuple &probe_tuple);
+
+  /**
+   * Fills probe_batch_ with the next probe side rows, all of them to be probed against the
+   * current table, @return false if there is none left.
+   */
+  bool NextProbeBatch();
+
+  /** Sets matches_ to the build tuples whose hash matches each row of probe_batch_. */
+  void MatchProbeBatch();
+
+  /** Appends the join results of the next matches_ to batch, as many as fit. */
+  void EmitMatches(VectorBatch *batch);
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_;
+  std::unique_ptr<AbstractExecutor> right_;
+  JoinHashTable table_;
+  bool built_;
+  /** true if the table holds the left child */
+  bool build_left_;
+  /** the child probing the table */
+  AbstractExecutor *probe_;
+  bool probe_end_;
+  /** probe side tuples read while picking the build side, or from a page of the probe partition */
+  std::vector<Tuple> probe_buffer_;
+  size_t probe_buffer_pos_;
+  std::vector<Tuple> output_;
+
+  /** true once the join ran out of memory and partitioned its children */
+  bool spilled_;
+  /** partition pairs not joined yet */
+  std::vector<PartitionPair> pending_;
+  /** unread pages of the probe partition of the pair being joined */
+  std::vector<page_id_t> probe_pages_;
+  size_t probe_pages_pos_;
+
+  /** probe side rows being joined by NextBatch */
+  VectorBatch probe_batch_;
+  /** the join keys of the rows of probe_batch_ */
+  std::vector<std::vector<Value>> probe_keys_;
+  /** (row of probe_batch_, build tuple) pairs whose hashes match */
+  std::vector<std::pair<size_t, const Tuple *>> matches_;
+  size_t matches_pos_;
+
+  static constexpr int BLOCK_TUPLES_NUM{4 * 20};
+  /** one TmpTuplePage per partition is pinned while partitioning */
+  static constexpr size_t NUM_PARTITIONS{16};
+  static constexpr uint32_t MAX_LEVELS{3};
+};
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "common/rid.h"
@@ -35,6 +36,8 @@ class IndexScanExecutor : public AbstractExecutor {
    */
   IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan);
 
+  ~IndexScanExecutor() override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
   void Init() override;
@@ -42,12 +45,30 @@ class IndexScanExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Iterates one BPlusTreeIndex instantiation, hides its key type from the executor */
+  class Cursor;
+  template <class KeyType, class ValueType, class KeyComparator>
+  class TreeCursor;
+  class VarlenCursor;
+
+  /** @return a cursor over the range if the index is a BPlusTreeIndex with these template arguments */
+  template <class KeyType, class ValueType, class KeyComparator>
+  std::unique_ptr<Cursor> MakeCursor(const Tuple *low_key, const Tuple *high_key);
+
+  /** @return true if every column read by the predicate and the output is an index key column */
+  bool IsCoveredByIndex() const;
+
+  static void CollectColumnIdxs(const AbstractExpression *expr, std::vector<uint32_t> *col_idxs);
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
   const AbstractExpression *predicate_;
   IndexInfo *index_info_;
   TableMetadata *table_meta_;
-  IndexIterator<GenericKey<8>, RID, GenericComparator<8>> iter_;
-  IndexIterator<GenericKey<8>, RID, GenericComparator<8>> end_iter_;
+  std::unique_ptr<Cursor> cursor_;
+  /** index-only scan, tuples are rebuilt from the keys instead of fetched from the table heap */
+  bool covering_{false};
+  /** table layout values of the current key, the non key columns are placeholders */
+  std::vector<Value> covering_values_;
 };
 }  // namespace bustub
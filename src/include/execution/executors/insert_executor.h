@@ -54,7 +54,5 @@ class InsertExecutor : public AbstractExecutor {
   const std::unique_ptr<AbstractExecutor> child_executor_;
 
   TableMetadata *table_info_;
-
-  std::vector<IndexInfo *> table_indexes_;
 };
 }  // namespace bustub
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * MergeJoinExecutor joins two children ordered on their join keys by advancing
+ * whichever side has the smaller key. The right tuples sharing a key are kept as a
+ * run, which every left tuple with that key is joined with, so duplicates on both
+ * sides cost memory for one right run only. Results come out in key order.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new merge join executor.
+   * @param exec_ctx the executor context
+   * @param plan the merge join plan to be executed
+   * @param left_executor the child executor that produces tuple for the left side of join
+   * @param right_executor the child executor that produces tuple for the right side of join
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_executor,
+                    std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+ private:
+  /**
+   * Reads the next tuple of the left (or right) child whose keys are not NULL, and its keys.
+   * @return false if the child ran out
+   */
+  bool Advance(bool left, Tuple *tuple, std::vector<Value> *keys);
+
+  /** @return <0, 0 or >0 as keys a compare to keys b */
+  static int CompareKeys(const std::vector<Value> &a, const std::vector<Value> &b);
+
+  /** Adds the join results of the current left tuple and the right run to output_. */
+  void JoinRun();
+
+  /** The merge join plan node to be executed. */
+  const MergeJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_;
+  std::unique_ptr<AbstractExecutor> right_;
+
+  Tuple left_tuple_;
+  std::vector<Value> left_keys_;
+  bool left_valid_;
+  /** the first right tuple after the run */
+  Tuple right_tuple_;
+  std::vector<Value> right_keys_;
+  bool right_valid_;
+  /** right tuples that all have the keys run_keys_ */
+  std::vector<Tuple> run_;
+  std::vector<Value> run_keys_;
+
+  std::vector<Tuple> output_;
+  size_t output_pos_;
+};
+}  // namespace bustub
@@ -48,11 +48,20 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /** Pull the next batch of outer tuples and probe the index for all of them at once. */
+  bool FetchBatch();
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   TableMetadata *inner_table_info_;
   IndexInfo *index_info_;
   int outter_join_colidx_;
+  std::vector<Tuple> batch_outer_tuples_;
+  std::vector<RID> batch_outer_rids_;
+  std::vector<std::vector<RID>> batch_inner_rids_;
+  size_t batch_cursor_;
+  // 一批外表元组一起探测索引, 排序后相邻的键可以复用同一个叶子页
+  static constexpr size_t BATCH_TUPLES_NUM{4 * 20};
 };
 }  // namespace bustub
@@ -37,6 +37,9 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /** Reads a batch of table tuples, then filters and projects the batch as a whole. */
+  bool NextBatch(VectorBatch *batch) override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
@@ -46,5 +49,9 @@ class SeqScanExecutor : public AbstractExecutor {
   TableIterator iter_;
   TableIterator end_iter_;
   const AbstractExpression *predicate_;
+  /** table tuples read by NextBatch, with the columns of the table schema */
+  VectorBatch scan_batch_;
+  /** the table columns the predicate and the output columns read, the only ones NextBatch deserializes */
+  std::vector<uint32_t> scan_column_idxs_;
 };
 }  // namespace bustub
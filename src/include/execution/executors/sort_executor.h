@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * Tournament tree of losers over k sorted sources, picks the smallest head of k
+ * sources with log k comparisons per element. Every inner node keeps the loser of the
+ * match played there and the winner moves up, so after the winner's source advances
+ * only the matches on its path to the root are replayed.
+ *
+ * beats(a, b) tells whether the head of source a comes out before the head of source b;
+ * it has to rank exhausted sources last.
+ */
+class LoserTree {
+ public:
+  template <typename Beats>
+  void Build(size_t k, Beats &&beats) {
+    k_ = k;
+    tree_.assign(k, 0);
+    std::vector<size_t> winners(2 * k);
+    for (size_t i = 0; i < k; ++i) {
+      winners[k + i] = i;
+    }
+    for (size_t node = k - 1; node >= 1; --node) {
+      size_t a = winners[2 * node];
+      size_t b = winners[2 * node + 1];
+      winners[node] = beats(a, b) ? a : b;
+      tree_[node] = beats(a, b) ? b : a;
+    }
+    tree_[0] = k == 1 ? 0 : winners[1];
+  }
+
+  /** @return the source with the smallest head */
+  size_t Top() const { return tree_[0]; }
+
+  /** Replays the matches of source Top() after its head changed. */
+  template <typename Beats>
+  void Replay(Beats &&beats) {
+    size_t winner = tree_[0];
+    for (size_t node = (k_ + winner) / 2; node >= 1; node /= 2) {
+      if (beats(tree_[node], winner)) {
+        std::swap(tree_[node], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  size_t k_{0};
+  /** tree_[0] is the winner, tree_[1, k) the losers of the inner nodes; source i is leaf k + i */
+  std::vector<size_t> tree_;
+};
+
+/**
+ * SortExecutor sorts the tuples of its child by the ORDER BY terms of the plan.
+ *
+ * Every tuple gets a normalized key, its ORDER BY values encoded so that comparing keys
+ * with memcmp gives the ORDER BY order, so sorting and merging never compare Values.
+ * Tuples are sorted in memory while they fit in the memory budget of the
+ * ExecutorContext; past it each budget full is sorted into a run on TmpTuplePages, and
+ * the runs are merged with a LoserTree, MAX_FAN_IN at a time.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child the child executor that produces the tuples to sort
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child);
+
+  ~SortExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Appends the normalized form of value to key: a NULL marker byte, then the value as
+   * big endian bytes with the order preserving transforms of its type, all inverted for DESC.
+   */
+  static void AppendSortKey(const Value &value, OrderByType order_by_type, std::string *key);
+
+ private:
+  struct SortEntry {
+    std::string key_;
+    Tuple tuple_;
+    /** the rid the child output with the tuple, runs keep it next to the tuple */
+    RID rid_;
+  };
+
+  /** A sorted run on TmpTuplePages, in order. */
+  using Run = std::vector<page_id_t>;
+
+  /** Reads a run back a page at a time. */
+  struct RunReader {
+    Run run_;
+    size_t page_pos_{0};
+    std::vector<Tuple> tuples_;
+    size_t pos_{0};
+    SortEntry head_;
+    bool valid_{false};
+  };
+
+  /** @return the normalized key of a child tuple */
+  std::string MakeKey(const Tuple &tuple) const;
+
+  /** Reads the whole child, sorting in memory or into runs. */
+  void Sort();
+
+  /** Sorts entries into a run and clears them. */
+  void WriteRun(std::vector<SortEntry> *entries);
+
+  /** Appends the tuple and rid of entry to the run being written to page, starting a new page when it is full. */
+  void AppendToRun(const SortEntry &entry, Run *run, TmpTuplePage **page);
+
+  /** Moves reader to the next tuple of its run, deleting the pages it is done with. */
+  void Advance(RunReader *reader);
+
+  /** @return whether the head of reader a comes out before the head of reader b, the earlier run on ties */
+  bool Beats(size_t a, size_t b) const;
+
+  /** Opens readers on runs and builds the tree over them. */
+  void StartMerge(std::vector<Run> &&runs);
+
+  /** Deletes the pages of every unread run. */
+  void DropRuns();
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_;
+  bool sorted_;
+
+  /** tuples sorted in memory */
+  std::vector<SortEntry> entries_;
+  size_t entries_pos_;
+
+  /** runs written so far */
+  std::vector<Run> runs_;
+  /** readers of the runs being merged, empty if the tuples fit in memory */
+  std::vector<RunReader> readers_;
+  LoserTree tree_;
+
+  static constexpr size_t MAX_FAN_IN{16};
+};
+}  // namespace bustub
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.h
+//
+// Identification: src/include/execution/executors/topn_executor.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * TopNExecutor outputs the first n tuples of its child in the order of a sort plan,
+ * the same tuples as a SortExecutor followed by a limit of n.
+ *
+ * It keeps the best n tuples seen so far in a max heap on their normalized keys, so a
+ * tuple that does not beat the worst of them is dropped after one key comparison, and
+ * memory stays O(n) however large the child is. ExecutorFactory builds one for a limit
+ * directly over a sort when FitsInMemory, and keeps the spilling SortExecutor otherwise.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new top-n executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan whose first n tuples are output
+   * @param n the number of tuples to output
+   * @param child the child executor of the sort
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, size_t n,
+               std::unique_ptr<AbstractExecutor> &&child);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Estimates the heap of n tuples of the plan from the longest tuple its child can produce.
+   * @return true if the heap fits in the memory budget of exec_ctx, always true if the budget is unlimited
+   */
+  static bool FitsInMemory(ExecutorContext *exec_ctx, const SortPlanNode *plan, size_t n);
+
+ private:
+  struct HeapEntry {
+    std::string key_;
+    /** position in the child's output, ties keep the earlier tuple like the stable sort */
+    size_t seq_;
+    Tuple tuple_;
+    /** the rid the child output with the tuple */
+    RID rid_;
+  };
+
+  static bool Less(const HeapEntry &a, const HeapEntry &b) {
+    int cmp = a.key_.compare(b.key_);
+    return cmp < 0 || (cmp == 0 && a.seq_ < b.seq_);
+  }
+
+  /** Reads the whole child into the heap and sorts it. */
+  void Build();
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  size_t n_;
+  std::unique_ptr<AbstractExecutor> child_;
+  bool built_;
+  /** a max heap on (key, seq) while building, then sorted ascending */
+  std::vector<HeapEntry> heap_;
+  size_t pos_;
+};
+}  // namespace bustub
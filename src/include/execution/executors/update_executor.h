@@ -88,15 +88,16 @@ class UpdateExecutor : public AbstractExecutor {
     //    return false;
   }
 
+  // called after the heap is written, so that an index registered later finds the new tuple in its initial scan
   void UpdateIndex(Tuple *old_tuple, Tuple *new_tuple, const RID &rid, bool must_update = false) {
-    for (const auto &index_info : table_indexes_) {
+    for (const auto &index_info : exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_)) {
       Index *index = index_info->index_.get();
       if (must_update || IsUpdateIndex(index->GetKeyAttrs())) {
         Schema table_schema = table_info_->schema_;
         Tuple old_key = old_tuple->KeyFromTuple(table_schema, index_info->key_schema_, index->GetKeyAttrs());
         Tuple new_key = new_tuple->KeyFromTuple(table_schema, index_info->key_schema_, index->GetKeyAttrs());
-        index->DeleteEntry(old_key, rid, exec_ctx_->GetTransaction());
-        index->InsertEntry(new_key, rid, exec_ctx_->GetTransaction());
+        index_info->DeleteEntry(old_key, rid, exec_ctx_->GetTransaction());
+        index_info->InsertEntry(new_key, rid, exec_ctx_->GetTransaction());
       }
     }
   }
@@ -108,7 +109,5 @@ class UpdateExecutor : public AbstractExecutor {
   const TableMetadata *table_info_;
   /** The child executor to obtain value from. */
   std::unique_ptr<AbstractExecutor> child_executor_;
-
-  std::vector<IndexInfo *> table_indexes_;
 };
 }  // namespace bustub
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/vector_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -58,6 +59,34 @@ class AbstractExpression {
    */
   virtual Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const = 0;
 
+  /**
+   * Evaluates every row of a batch, whose columns are those of the schema Evaluate would take.
+   * @param batch the rows
+   * @param[out] result the value of each row
+   */
+  virtual void EvaluateBatch(const VectorBatch &batch, std::vector<Value> *result) const = 0;
+
+  /**
+   * Evaluates a join on rows of the same position in two batches of equal size.
+   * @param left_batch the left rows
+   * @param right_batch the right rows
+   * @param[out] result the value of each pair of rows
+   */
+  virtual void EvaluateJoinBatch(const VectorBatch &left_batch, const VectorBatch &right_batch,
+                                 std::vector<Value> *result) const = 0;
+
+  /**
+   * Evaluates a batch like EvaluateBatch, but for an expression that only reads a column
+   * returns the column itself instead of copying it.
+   * @param batch the rows
+   * @param scratch where the values are evaluated to otherwise
+   * @return the value of each row
+   */
+  virtual const std::vector<Value> &EvaluateBatchRef(const VectorBatch &batch, std::vector<Value> *scratch) const {
+    EvaluateBatch(batch, scratch);
+    return *scratch;
+  }
+
   /** @return the child_idx'th child of this expression */
   const AbstractExpression *GetChildAt(uint32_t child_idx) const { return children_[child_idx]; }
 
@@ -46,6 +46,15 @@ class AggregateValueExpression : public AbstractExpression {
     return is_group_by_term_ ? group_bys[term_idx_] : aggregates[term_idx_];
   }
 
+  void EvaluateBatch(const VectorBatch &batch, std::vector<Value> *result) const override {
+    BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
+  }
+
+  void EvaluateJoinBatch(const VectorBatch &left_batch, const VectorBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
+  }
+
  private:
   bool is_group_by_term_;
   uint32_t term_idx_;
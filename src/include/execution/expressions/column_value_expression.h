@@ -45,6 +45,19 @@ class ColumnValueExpression : public AbstractExpression {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
 
+  void EvaluateBatch(const VectorBatch &batch, std::vector<Value> *result) const override {
+    *result = batch.GetColumn(col_idx_);
+  }
+
+  const std::vector<Value> &EvaluateBatchRef(const VectorBatch &batch, std::vector<Value> *scratch) const override {
+    return batch.GetColumn(col_idx_);
+  }
+
+  void EvaluateJoinBatch(const VectorBatch &left_batch, const VectorBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    *result = (tuple_idx_ == 0 ? left_batch : right_batch).GetColumn(col_idx_);
+  }
+
   uint32_t GetTupleIdx() const { return tuple_idx_; }
   uint32_t GetColIdx() const { return col_idx_; }
 
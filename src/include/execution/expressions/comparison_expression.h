@@ -53,6 +53,24 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  void EvaluateBatch(const VectorBatch &batch, std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    CompareBatch(GetChildAt(0)->EvaluateBatchRef(batch, &lhs), GetChildAt(1)->EvaluateBatchRef(batch, &rhs), result);
+  }
+
+  void EvaluateJoinBatch(const VectorBatch &left_batch, const VectorBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    GetChildAt(0)->EvaluateJoinBatch(left_batch, right_batch, &lhs);
+    GetChildAt(1)->EvaluateJoinBatch(left_batch, right_batch, &rhs);
+    CompareBatch(lhs, rhs, result);
+  }
+
+  /** @return the type of comparison performed by this expression */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
@@ -73,6 +91,14 @@ class ComparisonExpression : public AbstractExpression {
     }
   }
 
+  void CompareBatch(const std::vector<Value> &lhs, const std::vector<Value> &rhs, std::vector<Value> *result) const {
+    result->clear();
+    result->reserve(lhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+      result->push_back(ValueFactory::GetBooleanValue(PerformComparison(lhs[i], rhs[i])));
+    }
+  }
+
   std::vector<const AbstractExpression *> children_;
   ComparisonType comp_type_;
 };
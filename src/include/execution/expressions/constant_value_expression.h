@@ -36,6 +36,15 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  void EvaluateBatch(const VectorBatch &batch, std::vector<Value> *result) const override {
+    result->assign(batch.Size(), val_);
+  }
+
+  void EvaluateJoinBatch(const VectorBatch &left_batch, const VectorBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    result->assign(left_batch.Size(), val_);
+  }
+
  private:
   Value val_;
 };
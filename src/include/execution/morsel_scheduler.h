@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_scheduler.h
+//
+// Identification: src/include/execution/morsel_scheduler.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * MorselScheduler runs a query on several threads, morsel-driven: every table scan is
+ * split into morsels of MORSEL_PAGES consecutive table pages that the worker threads
+ * take from a shared counter as they go, so a slow worker only delays its last morsel.
+ *
+ * A worker pushes each tuple of its morsel through the operators above the scan up to
+ * the next pipeline breaker, which keeps thread-local state that is merged once every
+ * morsel is done:
+ * - an aggregation merges the partial aggregates of the per-worker hash tables;
+ * - a hash join gathers the build tuples of all workers into one JoinHashTable, built on
+ *   the right child, and then the left child's workers probe it concurrently;
+ * - a sort sorts each worker's tuples and merges the sorted lists with a LoserTree.
+ *
+ * Rows come out in the same order as from the single-threaded executors where that
+ * order is defined (a scan in table order, a sort), otherwise the same rows in some
+ * order. The breakers hold their input in memory, so ExecutionEngine runs a query with
+ * a memory budget on the single-threaded executors instead.
+ */
+class MorselScheduler {
+ public:
+  /**
+   * Creates a scheduler for one query.
+   * @param exec_ctx the executor context of the query
+   * @param parallelism the number of worker threads, the calling thread being one of them
+   */
+  MorselScheduler(ExecutorContext *exec_ctx, size_t parallelism);
+
+  /** @return true if every node of plan can run in parallel: scans, aggregations, hash joins and sorts */
+  static bool CanParallelize(const AbstractPlanNode *plan);
+
+  /**
+   * Runs a plan for which CanParallelize holds.
+   * @param plan the plan to execute
+   * @param[out] result_set the output rows, if not null
+   */
+  void Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set);
+
+  /** the number of table pages a worker scans at a time */
+  static constexpr size_t MORSEL_PAGES{4};
+
+ private:
+  /**
+   * Takes an output row of a plan from worker worker. order ranks the row the way the
+   * single-threaded plan would output it, where it defines an order.
+   */
+  using Consumer = std::function<void(size_t worker, uint64_t order, const Tuple &tuple)>;
+
+  /** Pushes the output rows of plan to consume, from the worker threads. */
+  void Produce(const AbstractPlanNode *plan, const Consumer &consume);
+
+  void ProduceSeqScan(const SeqScanPlanNode *plan, const Consumer &consume);
+
+  void ProduceHashJoin(const HashJoinPlanNode *plan, const Consumer &consume);
+
+  void ProduceAggregation(const AggregationPlanNode *plan, const Consumer &consume);
+
+  void ProduceSort(const SortPlanNode *plan, const Consumer &consume);
+
+  /** Runs task(worker) on parallelism_ threads and waits for them, rethrowing the first exception. */
+  void RunOnWorkers(const std::function<void(size_t worker)> &task);
+
+  ExecutorContext *exec_ctx_;
+  size_t parallelism_;
+};
+}  // namespace bustub
@@ -14,6 +14,9 @@
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
@@ -24,13 +27,17 @@ class IndexScanPlanNode : public AbstractPlanNode {
  public:
   /**
    * Creates a new index scan plan node.
+   * A predicate of the form "column op constant" is also turned into a key range, so that the scan
+   * only visits the leaves between the bounds when the column is the index key.
    * @param output the output format of this scan plan node
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) == true or predicate ==
    * nullptr
    * @param table_oid the identifier of table to be scanned
    */
   IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid) {}
+      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid) {
+    DeriveKeyRange();
+  }
 
   PlanType GetType() const override { return PlanType::IndexScan; }
 
@@ -40,11 +47,90 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** @return the identifier of the table that should be scanned */
   index_oid_t GetIndexOid() const { return index_oid_; }
 
+  /** @return true if the predicate bounds the column GetKeyColIdx() from at least one side */
+  bool HasKeyRange() const { return has_low_key_ || has_high_key_; }
+
+  /** @return the table column the key range applies to */
+  uint32_t GetKeyColIdx() const { return key_col_idx_; }
+
+  bool HasLowKey() const { return has_low_key_; }
+  const Value &GetLowKey() const { return low_key_; }
+  bool IsLowKeyInclusive() const { return low_key_inclusive_; }
+
+  bool HasHighKey() const { return has_high_key_; }
+  const Value &GetHighKey() const { return high_key_; }
+  bool IsHighKeyInclusive() const { return high_key_inclusive_; }
+
  private:
+  void DeriveKeyRange() {
+    const auto *comp_exp = dynamic_cast<const ComparisonExpression *>(predicate_);
+    if (comp_exp == nullptr) {
+      return;
+    }
+    ComparisonType comp_type = comp_exp->GetComparisonType();
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(comp_exp->GetChildAt(0));
+    const auto *constant = dynamic_cast<const ConstantValueExpression *>(comp_exp->GetChildAt(1));
+    if (column == nullptr || constant == nullptr) {
+      // constant op column, mirror the comparison
+      column = dynamic_cast<const ColumnValueExpression *>(comp_exp->GetChildAt(1));
+      constant = dynamic_cast<const ConstantValueExpression *>(comp_exp->GetChildAt(0));
+      if (column == nullptr || constant == nullptr) {
+        return;
+      }
+      switch (comp_type) {
+        case ComparisonType::LessThan:
+          comp_type = ComparisonType::GreaterThan;
+          break;
+        case ComparisonType::LessThanOrEqual:
+          comp_type = ComparisonType::GreaterThanOrEqual;
+          break;
+        case ComparisonType::GreaterThan:
+          comp_type = ComparisonType::LessThan;
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          comp_type = ComparisonType::LessThanOrEqual;
+          break;
+        default:
+          break;
+      }
+    }
+    Value value = constant->Evaluate(nullptr, nullptr);
+    switch (comp_type) {
+      case ComparisonType::Equal:
+        has_low_key_ = has_high_key_ = true;
+        low_key_ = high_key_ = value;
+        low_key_inclusive_ = high_key_inclusive_ = true;
+        break;
+      case ComparisonType::LessThan:
+      case ComparisonType::LessThanOrEqual:
+        has_high_key_ = true;
+        high_key_ = value;
+        high_key_inclusive_ = comp_type == ComparisonType::LessThanOrEqual;
+        break;
+      case ComparisonType::GreaterThan:
+      case ComparisonType::GreaterThanOrEqual:
+        has_low_key_ = true;
+        low_key_ = value;
+        low_key_inclusive_ = comp_type == ComparisonType::GreaterThanOrEqual;
+        break;
+      default:
+        return;
+    }
+    key_col_idx_ = column->GetColIdx();
+  }
+
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
+  /** Key range derived from the predicate, an unset bound leaves that side of the scan open. */
+  uint32_t key_col_idx_{0};
+  bool has_low_key_{false};
+  Value low_key_;
+  bool low_key_inclusive_{true};
+  bool has_high_key_{false};
+  Value high_key_;
+  bool high_key_inclusive_{true};
 };
 
 }  // namespace bustub
@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_plan.h
+//
+// Identification: src/include/execution/plans/merge_join_plan.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/index_scan_plan.h"
+
+namespace bustub {
+/**
+ * MergeJoinPlanNode is an equi-join of two children that both produce their tuples in
+ * ascending order of their join keys: a left and a right tuple are joined if every left
+ * key equals the right key at the same position, and predicate, if any, holds on the pair.
+ * Keys that are NULL never join.
+ */
+class MergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new merge join plan node.
+   * @param output_schema the output format of this merge join node
+   * @param children the left and the right child plans, ordered on their keys
+   * @param left_keys the join key expressions, evaluated on the tuples of the left child
+   * @param right_keys the join key expressions, evaluated on the tuples of the right child
+   * @param predicate extra join condition checked on every pair with equal keys, nullptr if there is none
+   */
+  MergeJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                    std::vector<const AbstractExpression *> &&left_keys,
+                    std::vector<const AbstractExpression *> &&right_keys, const AbstractExpression *predicate = nullptr)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        left_keys_(std::move(left_keys)),
+        right_keys_(std::move(right_keys)),
+        predicate_(predicate) {
+    BUSTUB_ASSERT(!left_keys_.empty() && left_keys_.size() == right_keys_.size(),
+                  "Merge joins need the same number of left and right keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::MergeJoin; }
+
+  /** @return the join key expressions of the left child */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_keys_; }
+
+  /** @return the join key expressions of the right child */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_keys_; }
+
+  /** @return the extra join condition, nullptr if there is none */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the left plan node of the merge join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the merge join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /**
+   * Checks whether child produces its tuples in ascending order of keys, i.e. it is an index
+   * scan and keys are output columns that hold a prefix of the index key columns, in order.
+   * A merge join can take two children for which this holds instead of a hash join.
+   */
+  static bool IsOrderedOn(Catalog *catalog, const AbstractPlanNode *child,
+                          const std::vector<const AbstractExpression *> &keys) {
+    const auto *scan_plan = dynamic_cast<const IndexScanPlanNode *>(child);
+    if (nullptr == scan_plan) {
+      return false;
+    }
+    const auto &key_attrs = catalog->GetIndex(scan_plan->GetIndexOid())->index_->GetKeyAttrs();
+    if (keys.size() > key_attrs.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const auto *key = dynamic_cast<const ColumnValueExpression *>(keys[i]);
+      if (nullptr == key || key->GetColIdx() >= child->OutputSchema()->GetColumnCount()) {
+        return false;
+      }
+      const auto *column =
+          dynamic_cast<const ColumnValueExpression *>(child->OutputSchema()->GetColumn(key->GetColIdx()).GetExpr());
+      if (nullptr == column || column->GetColIdx() != key_attrs[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::vector<const AbstractExpression *> left_keys_;
+  std::vector<const AbstractExpression *> right_keys_;
+  /** The extra join condition. */
+  const AbstractExpression *predicate_;
+};
+
+}  // namespace bustub
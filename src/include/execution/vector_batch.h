@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// vector_batch.h
+//
+// Identification: src/include/execution/vector_batch.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+/**
+ * VectorBatch holds up to about CAPACITY rows column by column: column i is a vector of
+ * the values of the i-th column of an output schema, and the rows have their RIDs. It is
+ * what AbstractExecutor::NextBatch passes between executors, so an operator handles a
+ * whole batch per call and no Tuple is serialized between operators.
+ */
+class VectorBatch {
+ public:
+  static constexpr size_t CAPACITY = 1024;
+
+  /** Empties the batch and gives it column_count columns. */
+  void Reset(uint32_t column_count) {
+    columns_.resize(column_count);
+    for (auto &column : columns_) {
+      column.clear();
+    }
+    rids_.clear();
+  }
+
+  /** @return the number of rows */
+  size_t Size() const { return rids_.size(); }
+
+  bool IsFull() const { return rids_.size() >= CAPACITY; }
+
+  uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  std::vector<Value> &GetColumn(uint32_t column_idx) { return columns_[column_idx]; }
+
+  const std::vector<Value> &GetColumn(uint32_t column_idx) const { return columns_[column_idx]; }
+
+  /** The RIDs of the rows, the size of the batch. Set them first when filling the columns one by one. */
+  std::vector<RID> &GetRids() { return rids_; }
+
+  const std::vector<RID> &GetRids() const { return rids_; }
+
+  /** Appends the values of a tuple of the given schema as a row. */
+  void AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid) {
+    for (uint32_t i = 0; i < columns_.size(); ++i) {
+      columns_[i].push_back(tuple.GetValue(schema, i));
+    }
+    rids_.push_back(rid);
+  }
+
+  /** Appends the values of the given columns of a tuple as a row, leaving the other columns empty. */
+  void AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid,
+                   const std::vector<uint32_t> &column_idxs) {
+    for (uint32_t i : column_idxs) {
+      columns_[i].push_back(tuple.GetValue(schema, i));
+    }
+    rids_.push_back(rid);
+  }
+
+  /** Appends row row of other, which has the same columns. */
+  void AppendRow(const VectorBatch &other, size_t row) {
+    for (uint32_t i = 0; i < columns_.size(); ++i) {
+      columns_[i].push_back(other.columns_[i][row]);
+    }
+    rids_.push_back(other.rids_[row]);
+  }
+
+  /** @return row row as a tuple of the given schema */
+  Tuple GetTuple(size_t row, const Schema *schema) const {
+    std::vector<Value> values;
+    values.reserve(columns_.size());
+    for (const auto &column : columns_) {
+      values.push_back(column[row]);
+    }
+    return Tuple(values, schema);
+  }
+
+  /** Keeps the rows whose value in selection is true, in order. Columns left empty stay empty. */
+  void Filter(const std::vector<Value> &selection) {
+    std::vector<std::vector<Value> *> columns;
+    for (auto &column : columns_) {
+      if (!column.empty()) {
+        columns.push_back(&column);
+      }
+    }
+    size_t size = 0;
+    for (size_t row = 0; row < rids_.size(); ++row) {
+      if (!selection[row].GetAs<bool>()) {
+        continue;
+      }
+      if (size != row) {
+        for (auto *column : columns) {
+          Swap((*column)[size], (*column)[row]);
+        }
+        rids_[size] = rids_[row];
+      }
+      ++size;
+    }
+    for (auto *column : columns) {
+      column->resize(size);
+    }
+    rids_.resize(size);
+  }
+
+ private:
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+};
+}  // namespace bustub
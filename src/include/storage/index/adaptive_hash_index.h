@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_hash_index.h
+//
+// Identification: src/include/storage/index/adaptive_hash_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * In memory cache from the hash of a hot key to the leaf page and slot it was last
+ * found at, so that a point lookup of that key can skip the descent from the root
+ * (the adaptive hash index of InnoDB).
+ *
+ * The cache only gives hints. The caller must latch the leaf, check IsCurrent, and
+ * check that the slot still holds the key; keys moved by splits, redistributes or
+ * removes then simply miss. Leaves that are freed can't be checked that way, so the
+ * tree calls FreeLeaf before unlatching a leaf it deletes, which retires every entry.
+ *
+ * A key is cached once HOT_LOOKUPS lookups have touched its counter. Entries and
+ * counters are direct mapped by hash, a colliding key replaces the entry.
+ */
+class AdaptiveHashIndex {
+ public:
+  // number of lookups of a key before it is cached
+  static constexpr uint8_t HOT_LOOKUPS = 8;
+
+  explicit AdaptiveHashIndex(size_t capacity) : entries_(capacity), counters_(capacity) {}
+
+  // count a lookup of the key, true once it is hot enough to be cached
+  bool Touch(hash_t hash) {
+    auto &counter = counters_[hash % counters_.size()];
+    uint8_t count = counter.load(std::memory_order_relaxed);
+    if (count >= HOT_LOOKUPS) {
+      return true;
+    }
+    counter.store(count + 1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // remember where the key is, call it while the leaf is latched
+  void Put(hash_t hash, page_id_t page_id, int slot) {
+    Entry &entry = entries_[hash % entries_.size()];
+    std::lock_guard<std::mutex> guard(LatchOf(hash));
+    entry = {hash, page_id, slot, epoch_.load()};
+  }
+
+  // the leaf and slot the key was last seen at and the epoch to pass to IsCurrent
+  bool Get(hash_t hash, page_id_t *page_id, int *slot, uint64_t *epoch) {
+    const Entry &entry = entries_[hash % entries_.size()];
+    std::lock_guard<std::mutex> guard(LatchOf(hash));
+    if (entry.page_id_ == INVALID_PAGE_ID || entry.hash_ != hash || entry.epoch_ != epoch_.load()) {
+      return false;
+    }
+    *page_id = entry.page_id_;
+    *slot = entry.slot_;
+    *epoch = entry.epoch_;
+    return true;
+  }
+
+  // false once a leaf has been freed after the entry was read, call it with the leaf latched
+  bool IsCurrent(uint64_t epoch) const { return epoch == epoch_.load(); }
+
+  void FreeLeaf() { ++epoch_; }
+
+ private:
+  struct Entry {
+    hash_t hash_{0};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    int slot_{0};
+    uint64_t epoch_{0};
+  };
+
+  static constexpr size_t NUM_LATCHES = 64;
+
+  std::mutex &LatchOf(hash_t hash) { return latches_[hash % entries_.size() % NUM_LATCHES]; }
+
+  std::vector<Entry> entries_;
+  std::vector<std::atomic<uint8_t>> counters_;
+  std::mutex latches_[NUM_LATCHES];
+  std::atomic<uint64_t> epoch_{0};
+};
+
+}  // namespace bustub
@@ -10,11 +10,15 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
 
 #include "concurrency/transaction.h"
+#include "storage/index/adaptive_hash_index.h"
+#include "storage/index/bloom_filter.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
@@ -23,6 +27,26 @@ namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/**
+ * EAGER: Remove merges or redistributes a leaf as soon as it is less than half full
+ * LAZY: Remove only reclaims empty leaves, sparse leaves are left to Compact(); deleting and
+ * reinserting keys of the same range then neither merges nor splits, and Remove latches the
+ * ancestors of a leaf only when its last key goes
+ */
+enum class MergePolicy { EAGER, LAZY };
+
+/**
+ * Pages of one level of a B+ tree, fill is the number of entries over the max size of a page.
+ */
+struct BPlusTreeLevelStats {
+  size_t num_pages_{0};
+  // pages whose fill was read, fewer than num_pages_ when GetStats samples the leaves
+  size_t num_sampled_{0};
+  double avg_fill_{0};
+  double min_fill_{0};
+  double max_fill_{0};
+};
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
@@ -39,6 +63,22 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  /**
+   * Shape of the tree reported by GetStats, for cost estimates and for deciding when to
+   * Compact() or rebuild an index.
+   */
+  struct Stats {
+    // number of levels, 0 for an empty tree
+    int height_{0};
+    // levels_[0] is the root, levels_.back() the leaves
+    std::vector<BPlusTreeLevelStats> levels_;
+    // number of keys, extrapolated from the sampled leaves
+    size_t num_keys_{0};
+    // smallest and largest key, only valid when height_ > 0
+    KeyType min_key_{};
+    KeyType max_key_{};
+  };
+
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                      int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
 
@@ -48,15 +88,46 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  // Build an empty tree from pairs sorted by key, pages of a level are filled by num_threads threads.
+  void BulkLoad(const std::vector<MappingType> &items, size_t num_threads = 1, Transaction *transaction = nullptr);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  void SetMergePolicy(MergePolicy merge_policy) { merge_policy_ = merge_policy; }
+
+  // keep a Bloom filter of the keys so that point lookups of absent keys skip the descent, 0 expected_keys drops it.
+  // The filter is built from the leaves, call it while no other thread uses the tree.
+  void SetBloomFilter(size_t expected_keys, double false_positive_rate = 0.01);
+
+  // cache the leaf of up to capacity frequently looked up keys so GetValue can skip the descent, 0 drops the cache.
+  // Call it while no other thread uses the tree.
+  void SetAdaptiveHashIndex(size_t capacity);
+
+  // walk the tree, every internal page is read but only about leaf_sample_rate of the leaves; pages are latched one
+  // at a time, so under concurrent writes the result is approximate
+  Stats GetStats(double leaf_sample_rate = 1.0);
+
+  // merge or redistribute every non root leaf that is less than half full, returns the number of pages freed
+  size_t Compact(Transaction *transaction);
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // batched point query over keys sorted in ascending order, results[i] holds the value of keys[i]
+  int GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                Transaction *transaction = nullptr);
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
+  // range scan over [low, high], nullptr leaves that side open, the iterator stops at high
+  INDEXITERATOR_TYPE Begin(const KeyType *low, const KeyType *high, bool low_inclusive = true,
+                           bool high_inclusive = true);
+  // reverse iterators walk from larger to smaller keys, both end at end()
+  INDEXITERATOR_TYPE rbegin();
+  INDEXITERATOR_TYPE RBegin(const KeyType *high, const KeyType *low, bool high_inclusive = true,
+                            bool low_inclusive = true);
   INDEXITERATOR_TYPE end();
 
   void Print(BufferPoolManager *bpm) {
@@ -77,11 +148,18 @@ class BPlusTree {
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
   // expose for test purpose
-  Page *FindLeafPage(const KeyType &key, bool leftMost = false);
+  Page *FindLeafPage(const KeyType &key, bool leftMost = false, bool rightMost = false);
+  // takes the root lock itself, used by IndexIterator to restart after a failed sibling latch
+  Page *FindLeafPageForRead(const KeyType &key, bool leftMost = false, bool rightMost = false);
 
  private:
   void StartNewTree(const KeyType &key, const ValueType &value);
 
+  // point lookup through the adaptive hash index, false on a miss or a stale entry
+  bool GetValueByHash(const KeyType &key, hash_t hash, std::vector<ValueType> *result);
+
+  bool InsertIntoRightmostLeaf(const KeyType &key, const ValueType &value);
+
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
@@ -94,8 +172,9 @@ class BPlusTree {
 
   void ReleaseAncestorsLock(Transaction *transaction);
 
+  // append: the last key of a rightmost leaf was just inserted, move only that key to the new page
   template <typename N>
-  N *Split(N *node);
+  N *Split(N *node, bool append = false);
 
   template <typename N>
   bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
@@ -104,11 +183,29 @@ class BPlusTree {
   bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
                 int index, Transaction *transaction = nullptr);
 
+  void ReleaseCoalescedPages(BPlusTreePage *neighbor_node, BPlusTreePage *node, Transaction *transaction);
+
   template <typename N>
   void Redistribute(N *neighbor_node, N *node, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
+  // first keys of the non root leaves less than half full, in key order
+  std::vector<KeyType> FindSparseLeaves();
+
+  static void AddFill(BPlusTreeLevelStats *level_stats, const BPlusTreePage *node);
+
+  static hash_t KeyHash(const KeyType &key) {
+    return BloomFilter::Hash(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+  }
+
+  // false only when key is surely not in the tree
+  bool MayContain(const KeyType &key) const {
+    return bloom_filter_ == nullptr || bloom_filter_->MayContain(KeyHash(key));
+  }
+
+  void UpdatePrevPageId(page_id_t page_id, page_id_t prev_page_id);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -121,10 +218,21 @@ class BPlusTree {
   // std::atomic_flag hold_root_ = ATOMIC_FLAG_INIT;
   mutable std::mutex mutex_;
   page_id_t root_page_id_;
+  // cached for InsertIntoRightmostLeaf, only changed while holding the write latch of the old rightmost leaf
+  std::atomic<page_id_t> rightmost_leaf_page_id_{INVALID_PAGE_ID};
+  // whether the last insert went to the end of the rightmost leaf, InsertIntoRightmostLeaf is only tried if so
+  std::atomic<bool> last_insert_appended_{true};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  std::atomic<MergePolicy> merge_policy_{MergePolicy::EAGER};
+  // every key inserted since it was built, removed keys included; nullptr unless SetBloomFilter was called
+  std::unique_ptr<BloomFilter> bloom_filter_;
+  // nullptr unless SetAdaptiveHashIndex was called
+  std::unique_ptr<AdaptiveHashIndex> adaptive_hash_index_;
+  // GetValues walks at most this many sibling leaves before descending from the root again
+  static constexpr int MAX_SIBLING_HOPS{2};
 };
 
 }  // namespace bustub
@@ -33,10 +33,42 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  // build the empty index from runs of (key, rid) pairs, for duplicate keys the first pair of the first run wins
+  void BulkLoad(std::vector<std::vector<MappingType>> *runs, size_t num_threads, Transaction *transaction);
+
+  void SetMergePolicy(MergePolicy merge_policy) { container_.SetMergePolicy(merge_policy); }
+
+  // see BPlusTree::SetBloomFilter, not safe against concurrent use of the index
+  void SetBloomFilter(size_t expected_keys, double false_positive_rate = 0.01) {
+    container_.SetBloomFilter(expected_keys, false_positive_rate);
+  }
+
+  // see BPlusTree::SetAdaptiveHashIndex, not safe against concurrent use of the index
+  void SetAdaptiveHashIndex(size_t capacity) { container_.SetAdaptiveHashIndex(capacity); }
+
+  // merge the sparse leaves left behind by MergePolicy::LAZY, returns the number of pages freed
+  size_t Compact(Transaction *transaction) { return container_.Compact(transaction); }
+
+  // shape of the underlying tree, see BPlusTree::GetStats
+  typename BPlusTree<KeyType, ValueType, KeyComparator>::Stats GetStats(double leaf_sample_rate = 1.0) {
+    return container_.GetStats(leaf_sample_rate);
+  }
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
+  INDEXITERATOR_TYPE GetBeginIterator(const KeyType *low, const KeyType *high, bool low_inclusive,
+                                      bool high_inclusive);
+
+  INDEXITERATOR_TYPE GetRBeginIterator();
+
+  INDEXITERATOR_TYPE GetRBeginIterator(const KeyType *high, const KeyType *low, bool high_inclusive,
+                                       bool low_inclusive);
+
   INDEXITERATOR_TYPE GetEndIterator();
 
  protected:
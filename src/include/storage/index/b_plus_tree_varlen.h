@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen.h
+//
+// Identification: src/include/storage/index/b_plus_tree_varlen.h
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "common/rwlatch.h"
+#include "concurrency/transaction.h"
+#include "storage/index/varlen_key.h"
+#include "storage/page/b_plus_tree_varlen_page.h"
+
+namespace bustub {
+
+class VarlenBPlusTree;
+
+/** (key bytes, rid) pair handed out by VarlenIndexIterator, decode the key with VarlenKey */
+using VarlenMappingType = std::pair<std::string, RID>;
+
+/**
+ * Iterator over a VarlenBPlusTree. It copies one leaf at a time and holds no latch
+ * or pin in between; the next leaf is found again from the root with the last key
+ * returned, so the iterator stays valid while the tree is modified.
+ */
+class VarlenIndexIterator {
+ public:
+  VarlenIndexIterator() = default;
+  // start at the first key not less than key, or at the first key of the tree when key is nullptr
+  VarlenIndexIterator(VarlenBPlusTree *tree, const VarlenKey *key);
+
+  bool isEnd() const { return pos_ >= entries_.size(); }
+
+  const VarlenMappingType &operator*() const { return entries_[pos_]; }
+
+  VarlenIndexIterator &operator++();
+
+ private:
+  VarlenBPlusTree *tree_{nullptr};
+  std::vector<VarlenMappingType> entries_;
+  size_t pos_{0};
+};
+
+/**
+ * B+ tree over variable length keys stored in slotted pages (BPlusTreeVarlenPage),
+ * used for VARCHAR keys: a page holds as many keys as their bytes allow instead of a
+ * fixed number of GenericKey slots.
+ *
+ * Unlike BPlusTree, pages are split by bytes rather than by count, an underfull page
+ * is only merged with a sibling when both fit in one page (no redistribution), and
+ * the whole tree is guarded by one reader-writer latch.
+ * Only unique keys are supported.
+ */
+class VarlenBPlusTree {
+  using LeafPage = BPlusTreeVarlenPage<RID>;
+  using InternalPage = BPlusTreeVarlenPage<page_id_t>;
+  friend class VarlenIndexIterator;
+
+ public:
+  // keys are at most a quarter of a page, so that a split always leaves room for the separator
+  static constexpr uint32_t MAX_KEY_SIZE = (PAGE_SIZE - VARLEN_PAGE_HEADER_SIZE) / 4 - sizeof(LeafPage::Slot);
+
+  VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const VarlenComparator &comparator);
+
+  // Returns true if this B+ tree has no keys and values.
+  bool IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+  // Insert a key-value pair into this B+ tree, false if the key exists or is longer than MAX_KEY_SIZE.
+  bool Insert(const VarlenKey &key, const RID &value, Transaction *transaction = nullptr);
+
+  // Remove a key and its value from this B+ tree.
+  void Remove(const VarlenKey &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const VarlenKey &key, std::vector<RID> *result, Transaction *transaction = nullptr);
+
+  // index iterator
+  VarlenIndexIterator Begin() { return VarlenIndexIterator(this, nullptr); }
+  VarlenIndexIterator Begin(const VarlenKey &key) { return VarlenIndexIterator(this, &key); }
+
+  // expose for test purpose
+  page_id_t GetRootPageId() const { return root_page_id_; }
+
+ private:
+  // pages from the root to the leaf of key (the leftmost leaf for nullptr), all pinned
+  void FindLeafPath(const VarlenKey *key, std::vector<Page *> *path, std::vector<int> *child_idxs);
+
+  void UnpinPath(const std::vector<Page *> &path, bool is_dirty);
+
+  // copy the entries of the leaf of key starting at key into entries, moving right past empty leaves
+  void LoadLeaf(const VarlenKey *key, bool inclusive, std::vector<VarlenMappingType> *entries);
+
+  void StartNewTree(const VarlenKey &key, const RID &value);
+
+  void InsertIntoParent(std::vector<Page *> *path, int level, const std::string &key, page_id_t new_page_id);
+
+  // insert the entry into a full page and move the upper part by bytes to a new page, returns its separator
+  template <typename ValueType>
+  std::pair<std::string, page_id_t> SplitInsert(BPlusTreeVarlenPage<ValueType> *page, int index, const VarlenKey &key,
+                                                const ValueType &value);
+
+  void Rebalance(std::vector<Page *> *path, const std::vector<int> &child_idxs, int level);
+
+  // move all entries of right into left if they fit, separator becomes the first key of an internal right page
+  template <typename ValueType>
+  bool Merge(BPlusTreeVarlenPage<ValueType> *left, BPlusTreeVarlenPage<ValueType> *right, const VarlenKey &separator);
+
+  void UpdateRootPageId();
+
+  // member variable
+  std::string index_name_;
+  ReaderWriterLatch latch_;
+  page_id_t root_page_id_{INVALID_PAGE_ID};
+  BufferPoolManager *buffer_pool_manager_;
+  VarlenComparator comparator_;
+  // a non root page using fewer bytes is merged with a sibling
+  static constexpr uint32_t MIN_USED_BYTES = PAGE_SIZE / 4;
+};
+
+}  // namespace bustub
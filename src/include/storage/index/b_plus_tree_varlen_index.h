@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_index.h
+//
+// Identification: src/include/storage/index/b_plus_tree_varlen_index.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "storage/index/b_plus_tree_varlen.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+/**
+ * Index over VarlenBPlusTree, keys are stored with the bytes they need instead of a fixed GenericKey size.
+ */
+class VarlenBPlusTreeIndex : public Index {
+ public:
+  VarlenBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager);
+
+  // throws OUT_OF_RANGE when the key is longer than VarlenBPlusTree::MAX_KEY_SIZE
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  VarlenIndexIterator GetBeginIterator();
+
+  VarlenIndexIterator GetBeginIterator(const Tuple &key);
+
+ protected:
+  // comparator for key
+  VarlenComparator comparator_;
+  // container
+  VarlenBPlusTree container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bloom_filter.h
+//
+// Identification: src/include/storage/index/bloom_filter.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "common/util/hash_util.h"
+
+namespace bustub {
+
+/**
+ * In memory Bloom filter over key hashes computed by Hash. MayContain never misses
+ * a hash that was added, and reports a hash that was not added with about the false
+ * positive rate given at construction while at most expected_keys have been added.
+ *
+ * Hashes can't be removed. Add and MayContain may run concurrently: the bits are
+ * set with atomic or, and a key added before it is published elsewhere (e.g. under
+ * a page latch) is seen by every reader that sees the key.
+ */
+class BloomFilter {
+ public:
+  BloomFilter(size_t expected_keys, double false_positive_rate) {
+    false_positive_rate = std::clamp(false_positive_rate, 1e-9, 0.5);
+    double ln2 = std::log(2.0);
+    double bits = -static_cast<double>(std::max<size_t>(expected_keys, 1)) * std::log(false_positive_rate) / ln2 / ln2;
+    words_ = std::vector<std::atomic<uint64_t>>(std::max<size_t>(1, static_cast<size_t>(std::ceil(bits / 64))));
+    num_hashes_ = std::clamp(static_cast<int>(std::lround(-std::log2(false_positive_rate))), 1, MAX_HASHES);
+  }
+
+  static hash_t Hash(const char *bytes, size_t length) { return HashUtil::HashBytes(bytes, length); }
+
+  void Add(hash_t hash) {
+    uint64_t h1 = hash;
+    uint64_t h2 = HashUtil::Mix(h1) | 1;
+    for (int i = 0; i < num_hashes_; ++i, h1 += h2) {
+      uint64_t bit = h1 % NumBits();
+      words_[bit >> 6].fetch_or(uint64_t{1} << (bit & 63), std::memory_order_relaxed);
+    }
+  }
+
+  bool MayContain(hash_t hash) const {
+    uint64_t h1 = hash;
+    uint64_t h2 = HashUtil::Mix(h1) | 1;
+    for (int i = 0; i < num_hashes_; ++i, h1 += h2) {
+      uint64_t bit = h1 % NumBits();
+      if ((words_[bit >> 6].load(std::memory_order_relaxed) & (uint64_t{1} << (bit & 63))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  size_t NumBits() const { return words_.size() << 6; }
+
+  int NumHashes() const { return num_hashes_; }
+
+ private:
+  static constexpr int MAX_HASHES = 16;
+
+  std::vector<std::atomic<uint64_t>> words_;
+  int num_hashes_;
+};
+
+}  // namespace bustub
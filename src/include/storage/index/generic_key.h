@@ -94,13 +94,39 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, integer_key_width_{other.integer_key_width_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema), integer_key_width_(ComputeIntegerKeyWidth(key_schema)) {}
+
+  /**
+   * @return byte width of the key when it is a single INTEGER/BIGINT column stored at offset 0,
+   * so that callers may compare the raw bytes as a native integer; 0 otherwise
+   */
+  inline int GetIntegerKeyWidth() const { return integer_key_width_; }
 
  private:
+  static int ComputeIntegerKeyWidth(const Schema *key_schema) {
+    if (key_schema == nullptr || key_schema->GetColumnCount() != 1) {
+      return 0;
+    }
+    const auto &col = key_schema->GetColumn(0);
+    if (col.GetOffset() != 0) {
+      return 0;
+    }
+    if (col.GetType() == TypeId::INTEGER && KeySize >= sizeof(int32_t)) {
+      return sizeof(int32_t);
+    }
+    if (col.GetType() == TypeId::BIGINT && KeySize >= sizeof(int64_t)) {
+      return sizeof(int64_t);
+    }
+    return 0;
+  }
+
   Schema *key_schema_;
+  int integer_key_width_;
 };
 
 }  // namespace bustub
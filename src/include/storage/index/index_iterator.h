@@ -19,6 +19,9 @@ namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
  public:
@@ -31,6 +34,14 @@ class IndexIterator {
   //                end_index_last_leaf);
   IndexIterator(BufferPoolManager *buffer_pool_manager, Page *leaf, int index_in_leaf);
 
+  // iterator over "tree", walks towards smaller keys when reverse is set and reaches end() once the current
+  // key passes stop_key (nullptr for an open range); start_key is the key the scan was positioned at (nullptr
+  // for the first leaf), where it continues if it has to restart before having left the first leaf
+  IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree, BufferPoolManager *buffer_pool_manager,
+                Page *leaf, int index_in_leaf, const KeyComparator *comparator, bool reverse = false,
+                const KeyType *stop_key = nullptr, bool stop_inclusive = true, const KeyType *start_key = nullptr,
+                bool start_inclusive = true);
+
   bool isEnd();
 
   const MappingType &operator*();
@@ -45,6 +56,18 @@ class IndexIterator {
   IndexIterator(const IndexIterator &rhs);
 
  private:
+  // move on to the sibling leaf when index_in_leaf_ ran off the current one, then check the stop key
+  void AdjustPosition();
+
+  // sibling could not be latched, descend again from the root and continue after the last key seen
+  void Restart();
+
+  // remember the boundary key of the current leaf, which the scan has passed, unless the leaf is empty or the
+  // key is behind the resume key already saved
+  void SaveResumeKey();
+
+  void ReleaseLeaf();
+
   // add your own private member variables here
   BufferPoolManager *buffer_pool_manager_{nullptr};
   B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_{nullptr};
@@ -52,6 +75,18 @@ class IndexIterator {
   //  BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *last_leaf_{nullptr};
   int index_in_leaf_{-1};
   //  int end_index_last_leaf_{};
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_{nullptr};
+  const KeyComparator *comparator_{nullptr};
+  bool reverse_{false};
+  // last key of a range scan (the upper bound, or the lower bound when reverse_)
+  bool has_stop_key_{false};
+  KeyType stop_key_{};
+  bool stop_inclusive_{true};
+  // key Restart continues after (or at, when resume_inclusive_): the boundary key of the last non-empty leaf
+  // left, since under LAZY merges the current leaf may be empty
+  bool has_resume_key_{false};
+  KeyType resume_key_{};
+  bool resume_inclusive_{false};
 };
 
 }  // namespace bustub
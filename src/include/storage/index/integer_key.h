@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// integer_key.h
+//
+// Identification: src/include/storage/index/integer_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Integer key is used for indexes whose key is a single INTEGER or BIGINT column.
+ *
+ * It has the same interface and byte layout as GenericKey<sizeof(IntType)>, but
+ * is compared as a native integer instead of through the key schema.
+ */
+template <typename IntType>
+class IntegerKey {
+  static_assert(std::is_integral_v<IntType> && std::is_signed_v<IntType>, "IntegerKey needs a signed integer");
+
+ public:
+  inline void SetFromKey(const Tuple &tuple) {
+    key_ = 0;
+    memcpy(&key_, tuple.GetData(), std::min<size_t>(tuple.GetLength(), sizeof(IntType)));
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) { key_ = static_cast<IntType>(key); }
+
+  inline Value ToValue(Schema *schema, uint32_t column_idx) const {
+    const auto &col = schema->GetColumn(column_idx);
+    return Value::DeserializeFrom(reinterpret_cast<const char *>(&key_) + col.GetOffset(), col.GetType());
+  }
+
+  // NOTE: for test purpose only
+  inline int64_t ToString() const { return key_; }
+
+  // NOTE: for test purpose only
+  friend std::ostream &operator<<(std::ostream &os, const IntegerKey &key) {
+    os << key.ToString();
+    return os;
+  }
+
+  IntType key_;
+};
+
+/**
+ * Function object returns < 0 if lhs < rhs, 0 if equal and > 0 otherwise, used for trees
+ */
+template <typename IntType>
+class IntegerComparator {
+ public:
+  inline int operator()(const IntegerKey<IntType> &lhs, const IntegerKey<IntType> &rhs) const {
+    return static_cast<int>(lhs.key_ > rhs.key_) - static_cast<int>(lhs.key_ < rhs.key_);
+  }
+
+  // the key schema is only taken to match GenericComparator, the key type says it all
+  explicit IntegerComparator(Schema * /*key_schema*/ = nullptr) {}
+};
+
+/**
+ * @return INTEGER or BIGINT when the key schema is that single column and an IntegerKey can index it, INVALID otherwise
+ */
+inline TypeId IntegerKeyType(const Schema &key_schema) {
+  if (key_schema.GetColumnCount() != 1 || key_schema.GetColumn(0).GetOffset() != 0) {
+    return TypeId::INVALID;
+  }
+  TypeId type = key_schema.GetColumn(0).GetType();
+  return type == TypeId::INTEGER || type == TypeId::BIGINT ? type : TypeId::INVALID;
+}
+
+}  // namespace bustub
@@ -0,0 +1,153 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// simd_key_search.h
+//
+// Identification: src/include/storage/index/simd_key_search.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "storage/index/generic_key.h"
+#include "storage/index/int_comparator.h"
+#include "storage/index/integer_key.h"
+
+namespace bustub {
+
+/*
+ * In-node key search used by the b+ tree pages.
+ *
+ * Pages keep (key, value) pairs interleaved in array[], so integer keys are
+ * pulled out with a strided gather. Binary search narrows the range down to
+ * SIMD_SEARCH_WINDOW slots, the rest is a branch free count of keys <= target.
+ */
+static constexpr int SIMD_SEARCH_WINDOW = 16;
+
+/** @return byte width of a key which can be compared as a native integer, 0 if unsupported */
+template <typename KeyComparator>
+inline int IntegerKeyWidth(const KeyComparator & /*comparator*/) {
+  return 0;
+}
+
+template <size_t KeySize>
+inline int IntegerKeyWidth(const GenericComparator<KeySize> &comparator) {
+  return comparator.GetIntegerKeyWidth();
+}
+
+inline int IntegerKeyWidth(const IntComparator & /*comparator*/) { return sizeof(int); }
+
+template <typename IntType>
+inline int IntegerKeyWidth(const IntegerComparator<IntType> & /*comparator*/) {
+  return sizeof(IntType);
+}
+
+template <typename IntType>
+inline IntType LoadIntegerKey(const void *src) {
+  IntType key;
+  memcpy(&key, src, sizeof(IntType));
+  return key;
+}
+
+/*
+ * Count keys in slots [lo, hi) which are <= key. Slots are "stride" bytes apart starting at base.
+ */
+template <typename IntType>
+inline int CountNotGreater(const char *base, size_t stride, int lo, int hi, IntType key) {
+  int count = 0;
+  int i = lo;
+#ifdef __AVX2__
+  const int s = static_cast<int>(stride);
+  if constexpr (sizeof(IntType) == sizeof(int64_t)) {
+    const __m256i target = _mm256_set1_epi64x(key);
+    const __m128i offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+    for (; i + 4 <= hi; i += 4) {
+      auto ptr = reinterpret_cast<const long long *>(base + i * stride);  // NOLINT
+      __m256i keys = _mm256_i32gather_epi64(ptr, offsets, 1);
+      int gt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(keys, target)));
+      count += 4 - __builtin_popcount(gt);
+    }
+  } else {
+    const __m256i target = _mm256_set1_epi32(key);
+    const __m256i offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    for (; i + 8 <= hi; i += 8) {
+      auto ptr = reinterpret_cast<const int *>(base + i * stride);
+      __m256i keys = _mm256_i32gather_epi32(ptr, offsets, 1);
+      int gt = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(keys, target)));
+      count += 8 - __builtin_popcount(gt);
+    }
+  }
+#endif
+  for (; i < hi; ++i) {
+    count += static_cast<int>(LoadIntegerKey<IntType>(base + i * stride) <= key);
+  }
+  return count;
+}
+
+/*
+ * @return the first index i in [lo, hi) with key(i) > key, or hi if there is none
+ */
+template <typename IntType>
+inline int UpperBoundIntegerKeys(const char *base, size_t stride, int lo, int hi, IntType key) {
+  while (hi - lo > SIMD_SEARCH_WINDOW) {
+    int mi = (lo + hi) >> 1;
+    if (key < LoadIntegerKey<IntType>(base + mi * stride)) {
+      hi = mi;
+    } else {
+      lo = mi + 1;
+    }
+  }
+  return lo + CountNotGreater<IntType>(base, stride, lo, hi, key);
+}
+
+/*
+ * Comparator based binary search, same contract as UpperBoundIntegerKeys
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+inline int KeyUpperBoundGeneric(const std::pair<KeyType, ValueType> *array, int lo, int hi, const KeyType &key,
+                                const KeyComparator &comparator) {
+  int mi;
+  while (lo < hi) {
+    mi = (lo + hi) >> 1;
+    if (comparator(key, array[mi].first) < 0) {
+      hi = mi;
+    } else {
+      lo = mi + 1;
+    }
+  }
+  return lo;
+}
+
+/*
+ * @return the first index i in [lo, hi) with array[i].first > key, or hi if there is none.
+ * Integer keys take the SIMD path, everything else falls back to the comparator.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+inline int KeyUpperBound(const std::pair<KeyType, ValueType> *array, int lo, int hi, const KeyType &key,
+                         const KeyComparator &comparator) {
+  const auto base = reinterpret_cast<const char *>(&array[0].first);
+  const size_t stride = sizeof(std::pair<KeyType, ValueType>);
+  switch (IntegerKeyWidth(comparator)) {
+    case sizeof(int32_t):
+      return UpperBoundIntegerKeys<int32_t>(base, stride, lo, hi, LoadIntegerKey<int32_t>(&key));
+    case sizeof(int64_t):
+      if constexpr (sizeof(KeyType) >= sizeof(int64_t)) {
+        return UpperBoundIntegerKeys<int64_t>(base, stride, lo, hi, LoadIntegerKey<int64_t>(&key));
+      }
+      break;
+    default:
+      break;
+  }
+  return KeyUpperBoundGeneric(array, lo, hi, key, comparator);
+}
+
+}  // namespace bustub
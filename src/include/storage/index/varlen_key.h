@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// varlen_key.h
+//
+// Identification: src/include/storage/index/varlen_key.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "storage/table/tuple.h"
+#include "type/type_util.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * Varlen key is a view of the raw bytes of a key tuple, used by VarlenBPlusTree.
+ *
+ * A key tuple is self-contained (the offsets of its varchar columns are relative
+ * to the tuple), so its bytes can be copied into a page as they are and decoded
+ * with the key schema later on. The key does not own the bytes.
+ */
+class VarlenKey {
+ public:
+  VarlenKey() = default;
+  VarlenKey(const char *data, uint32_t size) : data_(data), size_(size) {}
+  explicit VarlenKey(const Tuple &tuple) : data_(tuple.GetData()), size_(tuple.GetLength()) {}
+  explicit VarlenKey(const std::string &bytes) : data_(bytes.data()), size_(static_cast<uint32_t>(bytes.size())) {}
+
+  inline Value ToValue(const Schema *schema, uint32_t column_idx) const {
+    const auto &col = schema->GetColumn(column_idx);
+    return Value::DeserializeFrom(ColumnData(col), col.GetType());
+  }
+
+  inline const char *ColumnData(const Column &col) const {
+    if (col.IsInlined()) {
+      return data_ + col.GetOffset();
+    }
+    return data_ + *reinterpret_cast<const uint32_t *>(data_ + col.GetOffset());
+  }
+
+  inline std::string ToBytes() const { return std::string(data_, size_); }
+
+  const char *data_{nullptr};
+  uint32_t size_{0};
+};
+
+/**
+ * Function object returns < 0 if lhs < rhs, 0 if equal and > 0 otherwise, used for trees
+ */
+class VarlenComparator {
+ public:
+  explicit VarlenComparator(const Schema *key_schema) : key_schema_(key_schema) {}
+
+  inline int operator()(const VarlenKey &lhs, const VarlenKey &rhs) const {
+    uint32_t column_count = key_schema_->GetColumnCount();
+    for (uint32_t i = 0; i < column_count; i++) {
+      const auto &col = key_schema_->GetColumn(i);
+      const char *lhs_data = lhs.ColumnData(col);
+      const char *rhs_data = rhs.ColumnData(col);
+      if (col.GetType() == TypeId::VARCHAR) {
+        // 非空字符串直接比较原始字节, 不构造 Value
+        uint32_t lhs_len = *reinterpret_cast<const uint32_t *>(lhs_data);
+        uint32_t rhs_len = *reinterpret_cast<const uint32_t *>(rhs_data);
+        if (lhs_len != BUSTUB_VALUE_NULL && rhs_len != BUSTUB_VALUE_NULL) {
+          int cmp = TypeUtil::CompareStrings(lhs_data + sizeof(uint32_t), lhs_len, rhs_data + sizeof(uint32_t),
+                                             rhs_len);
+          if (cmp != 0) {
+            return cmp < 0 ? -1 : 1;
+          }
+          continue;
+        }
+      }
+      Value lhs_value = Value::DeserializeFrom(lhs_data, col.GetType());
+      Value rhs_value = Value::DeserializeFrom(rhs_data, col.GetType());
+      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+        return -1;
+      }
+      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+        return 1;
+      }
+    }
+    // equals
+    return 0;
+  }
+
+ private:
+  const Schema *key_schema_;
+};
+
+}  // namespace bustub
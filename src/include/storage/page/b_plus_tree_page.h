@@ -17,6 +17,7 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "storage/index/generic_key.h"
+#include "storage/index/integer_key.h"
 
 namespace bustub {
 
@@ -41,7 +42,8 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * ----------------------------------------------------------------------------
  */
 
-enum AccessMode { SEARCH, DELETE, INSERT };
+// LAZY_DELETE: a leaf is only rebalanced once it is empty, see MergePolicy in b_plus_tree.h
+enum AccessMode { SEARCH, DELETE, INSERT, LAZY_DELETE };
 class BPlusTreePage {
  public:
   bool IsLeafPage() const;
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_page.h
+//
+// Identification: src/include/storage/page/b_plus_tree_varlen_page.h
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+
+#include "storage/index/varlen_key.h"
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define VARLEN_PAGE_HEADER_SIZE 36
+
+/**
+ * Slotted B+ tree page for variable length keys, used as leaf page (ValueType = RID)
+ * and as internal page (ValueType = page_id_t) of VarlenBPlusTree.
+ *
+ * The slot array grows from the header towards the end of the page and holds the
+ * values together with the position of their keys; key bytes are stored in a heap
+ * growing from the end of the page towards the slots. Slots are kept in key order,
+ * the heap is not. Removing an entry leaves its key bytes as a hole in the heap,
+ * holes are reclaimed by Compact() once an insert does not fit in the gap between
+ * slot array and heap.
+ * In an internal page the first key is empty and ignored, like BPlusTreeInternalPage.
+ *
+ * Page format:
+ *  ----------------------------------------------------------------------------
+ * | HEADER | SLOT(1) | SLOT(2) | ... | SLOT(n) | free ... | KEY(k) | ... | KEY(j) |
+ *  ----------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 36 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  ---------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | HeapBegin (4) | KeyBytes (4) |
+ *  ---------------------------------------------------------------------
+ *
+ *  Slot format: | KeyOffset (2) | KeyLength (2) | Value |
+ */
+template <typename ValueType>
+class BPlusTreeVarlenPage : public BPlusTreePage {
+ public:
+  struct Slot {
+    uint16_t offset_;
+    uint16_t length_;
+    ValueType value_;
+  };
+
+  // After creating a new page from buffer pool, must call initialize
+  // method to set default values
+  void Init(page_id_t page_id, IndexPageType page_type);
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  VarlenKey KeyAt(int index) const;
+  const ValueType &ValueAt(int index) const { return slots_[index].value_; }
+  void SetValueAt(int index, const ValueType &value) { slots_[index].value_ = value; }
+
+  // bytes taken by slots and live keys, holes in the heap are not counted
+  uint32_t UsedBytes() const { return GetSize() * sizeof(Slot) + key_bytes_; }
+  // bytes available to new entries, counting the holes Compact() would reclaim
+  uint32_t FreeBytes() const { return PAGE_SIZE - VARLEN_PAGE_HEADER_SIZE - UsedBytes(); }
+  bool HasRoom(uint32_t key_size) const { return FreeBytes() >= key_size + sizeof(Slot); }
+
+  // first index in [begin, size) whose key is not less than key
+  int LowerBound(const VarlenKey &key, const VarlenComparator &comparator, int begin = 0) const;
+  // first index in [begin, size) whose key is greater than key
+  int UpperBound(const VarlenKey &key, const VarlenComparator &comparator, int begin = 0) const;
+
+  // insert before index, the caller checks HasRoom() first
+  void InsertAt(int index, const VarlenKey &key, const ValueType &value);
+  void RemoveAt(int index);
+  // rewrite the live keys to the end of the page so that the free bytes are contiguous
+  void Compact();
+
+ private:
+  page_id_t next_page_id_;
+  uint32_t heap_begin_;
+  uint32_t key_bytes_;
+  Slot slots_[0];
+};
+
+}  // namespace bustub
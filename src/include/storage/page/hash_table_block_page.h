@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -26,12 +27,15 @@ namespace bustub {
  * non-unique keys.
  *
  * Block page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------------
+ * | OCCUPIED | READABLE | TAG(1) ... TAG(n) | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ---------------------------------------------------------------------------------------------
  *
  *  Here '+' means concatenation.
  *
+ * Every slot also keeps a one byte tag taken from the hash of its key (as in
+ * Swiss tables), so a probe compares the tags of TAG_GROUP_SIZE slots with one
+ * SIMD instruction and only compares the full keys of the slots whose tag matches.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBlockPage {
@@ -64,11 +68,12 @@ class HashTableBlockPage {
    * @param bucket_ind index to write the key and value to
    * @param key key to insert
    * @param value value to insert
+   * @param tag TagOf the hash of key, MatchTag finds the pair by it
    * @return If the value is inserted successfully, it returns true. If the
    * index is marked as occupied before the key and value can be inserted,
    * Insert returns false.
    */
-  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value);
+  bool Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value, uint8_t tag = 0);
 
   /**
    * Removes a key and value at index.
@@ -93,11 +98,36 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * @param hash hash of a key
+   * @return the tag of the key, its top 8 hash bits; the low bits already pick the slot
+   */
+  static uint8_t TagOf(uint64_t hash) { return static_cast<uint8_t>(hash >> 56); }
+
+  /**
+   * Compares the tags of the TAG_GROUP_SIZE slots starting at group_ind with tag.
+   *
+   * @param group_ind first slot of the group, a multiple of TAG_GROUP_SIZE
+   * @param tag tag to look for
+   * @return bit i set if the tag of slot group_ind + i equals tag, slots past the block included
+   */
+  uint32_t MatchTag(slot_offset_t group_ind, uint8_t tag) const;
+
+  /**
+   * @param group_ind first slot of the group, a multiple of TAG_GROUP_SIZE
+   * @return bit i set if slot group_ind + i is occupied
+   */
+  uint32_t OccupiedMask(slot_offset_t group_ind) const;
+
  private:
-  std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  static constexpr size_t NUM_GROUPS = (BLOCK_ARRAY_SIZE - 1) / TAG_GROUP_SIZE + 1;
+
+  std::atomic_char occupied_[NUM_GROUPS * TAG_GROUP_SIZE / 8];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  // a tag is only meaningful while its slot is readable
+  uint8_t tags_[NUM_GROUPS * TAG_GROUP_SIZE];
   MappingType array_[0];
 };
 
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Bucket page of an extendible hash table. Stores unordered (key, value) pairs,
+ * non-unique keys are supported but a pair is stored at most once.
+ *
+ * Bucket page format:
+ *  ----------------------------------------------------------------------------------
+ * | OCCUPIED | READABLE | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------------------
+ *
+ * Unlike a HashTableBlockPage the whole bucket is searched, so a removed slot is
+ * reused by the next insert. Callers latch the page, the flags are not atomic.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /**
+   * Appends the values of all pairs with the given key to result.
+   * @return true if any value was found
+   */
+  bool GetValue(const KeyType &key, const KeyComparator &comparator, std::vector<ValueType> *result) const;
+
+  /**
+   * Inserts a pair into a free slot.
+   * @return false if the pair is already in the bucket or the bucket is full
+   */
+  bool Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  /**
+   * Removes a pair.
+   * @return false if the pair is not in the bucket
+   */
+  bool Remove(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  KeyType KeyAt(slot_offset_t bucket_idx) const;
+
+  ValueType ValueAt(slot_offset_t bucket_idx) const;
+
+  void RemoveAt(slot_offset_t bucket_idx);
+
+  /**
+   * @return true if the slot holds or has held a pair
+   */
+  bool IsOccupied(slot_offset_t bucket_idx) const;
+
+  /**
+   * @return true if the slot holds a pair
+   */
+  bool IsReadable(slot_offset_t bucket_idx) const;
+
+  /**
+   * @return the number of pairs in the bucket
+   */
+  uint32_t NumReadable() const;
+
+  bool IsFull() const;
+
+  bool IsEmpty() const;
+
+ private:
+  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  // 0 if tombstone/brand new (never occupied), 1 otherwise.
+  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  MappingType array_[0];
+};
+
+}  // namespace bustub
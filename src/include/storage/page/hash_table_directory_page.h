@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Directory Page for extendible hash table.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | GlobalDepth(4) | LocalDepths(512) | BucketPageIds(2048) | Free(1524)
+ * --------------------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  // the directory has at most DIRECTORY_ARRAY_SIZE = 1 << MAX_DEPTH slots
+  static constexpr uint32_t MAX_DEPTH = 9;
+
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * Sets the page ID of this page
+   *
+   * @param page_id the page id for the page id field to be set to
+   */
+  void SetPageId(page_id_t page_id);
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number for the lsn field to be set to
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return the number of hash bits the directory is indexed by
+   */
+  uint32_t GetGlobalDepth() const;
+
+  /**
+   * @return mask of GetGlobalDepth() low bits, a hash anded with it is a directory index
+   */
+  uint32_t GetGlobalDepthMask() const;
+
+  /**
+   * Doubles the directory, the upper half points to the same buckets as the lower half
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halves the directory, only valid when CanShrink()
+   */
+  void DecrGlobalDepth();
+
+  /**
+   * @return true if every bucket has a local depth below the global depth
+   */
+  bool CanShrink() const;
+
+  /**
+   * @return the number of directory slots in use, 1 << GetGlobalDepth()
+   */
+  uint32_t Size() const;
+
+  /**
+   * @param bucket_idx directory index
+   * @return the page id of the bucket at bucket_idx
+   */
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  /**
+   * @param bucket_idx directory index
+   * @param bucket_page_id page id of the bucket bucket_idx now points to
+   */
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  /**
+   * @param bucket_idx directory index
+   * @return the number of hash bits shared by all keys of the bucket at bucket_idx
+   */
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  /**
+   * @param bucket_idx directory index
+   * @param local_depth the local depth of the bucket at bucket_idx
+   */
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth);
+
+  /**
+   * @param bucket_idx directory index
+   * @return mask of the local depth low bits of the bucket at bucket_idx
+   */
+  uint32_t GetLocalDepthMask(uint32_t bucket_idx) const;
+
+  /**
+   * @param bucket_idx directory index
+   * @return the index that differs from bucket_idx only in the highest local depth bit,
+   * the bucket there is the one bucket_idx was split from or is merged with
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+ private:
+  lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -14,11 +14,28 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
+/** TAG_GROUP_SIZE is the number of slot tags a block page compares with one SIMD instruction */
+#ifdef __AVX2__
+#define TAG_GROUP_SIZE 32
+#else
+#define TAG_GROUP_SIZE 16
+#endif
+
 /** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need two additional bits for occupied_ and readable_ and one byte for its hash tag.
+ * 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 5) = PAGE_SIZE/(sizeof (MappingType) + 1.25) because 1.25 bytes is the
+ * space required to maintain the occupied and readable flags and the tag of a key value pair. TAG_GROUP_SIZE bytes are
+ * held back for the tag array, which is padded to whole groups.*/
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - TAG_GROUP_SIZE) / (4 * sizeof(MappingType) + 5))
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs in an extendible hash table bucket page. It has no tags, so
+ * the calculation is the one for occupied_ and readable_ alone: PAGE_SIZE/(sizeof (MappingType) + 0.25). */
+#define BUCKET_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+
+/** DIRECTORY_ARRAY_SIZE is the number of bucket page ids an extendible hash table directory page holds */
+#define DIRECTORY_ARRAY_SIZE 512
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
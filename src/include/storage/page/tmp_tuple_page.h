@@ -1,15 +1,15 @@
 #pragma once
 
+#include <cstring>
+#include <vector>
+
+#include "common/rid.h"
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
  * TmpTuplePage format:
  *
@@ -17,17 +17,93 @@ namespace bustub {
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
  * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ *
+ * Tuples are only ever appended; operators use the pages as scratch space for
+ * intermediate results (e.g. the partitions of a hash join that do not fit in memory).
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  /** Initializes an empty page, page_size is the end of the tuple area (PAGE_SIZE for buffer pool pages). */
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Appends a tuple in front of the tuples already on the page.
+   * @param tuple the tuple to insert
+   * @param[out] out where the size of the tuple was written, followed by its data
+   * @return false if the page has no room for the tuple
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_TUPLE_PAGE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
+  }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /**
+   * Appends a tuple in front of the tuples already on the page, followed by rid. A page holds
+   * tuples inserted either with or without rids, and is read back by the matching GetTuples.
+   * @return false if the page has no room for the tuple
+   */
+  bool Insert(const Tuple &tuple, const RID &rid) {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength() + sizeof(int64_t);
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    if (free_space_pointer < SIZE_TMP_TUPLE_PAGE_HEADER + size) {
+      return false;
+    }
+    free_space_pointer -= size;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    int64_t rid_bits = rid.Get();
+    memcpy(GetData() + free_space_pointer + size - sizeof(int64_t), &rid_bits, sizeof(int64_t));
+    SetFreeSpacePointer(free_space_pointer);
+    return true;
+  }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /** Reads the tuple that Insert put at tmp_tuple. */
+  void Get(const TmpTuple &tmp_tuple, Tuple *tuple) { tuple->DeserializeFrom(GetData() + tmp_tuple.GetOffset()); }
+
+  /** Appends every tuple on the page to tuples, the most recently inserted first. */
+  void GetTuples(std::vector<Tuple> *tuples) {
+    for (uint32_t offset = GetFreeSpacePointer(); offset < PAGE_SIZE;) {
+      tuples->emplace_back();
+      tuples->back().DeserializeFrom(GetData() + offset);
+      offset += sizeof(uint32_t) + tuples->back().GetLength();
+    }
+  }
+
+  /** Appends every tuple on a page filled with rids to tuples, each carrying its rid, the most recent first. */
+  void GetTuplesWithRids(std::vector<Tuple> *tuples) {
+    for (uint32_t offset = GetFreeSpacePointer(); offset < PAGE_SIZE;) {
+      uint32_t length = *reinterpret_cast<uint32_t *>(GetData() + offset);
+      int64_t rid_bits;
+      memcpy(&rid_bits, GetData() + offset + sizeof(uint32_t) + length, sizeof(int64_t));
+      tuples->emplace_back(RID(rid_bits));
+      tuples->back().DeserializeFrom(GetData() + offset);
+      offset += sizeof(uint32_t) + length + sizeof(int64_t);
+    }
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+  static constexpr size_t SIZE_TMP_TUPLE_PAGE_HEADER = 12;
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+
+  /** @return pointer to the end of the current free space */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
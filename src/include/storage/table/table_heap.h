@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -59,6 +63,16 @@ class TableHeap {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
 
+  /**
+   * Insert a tuple starting from the last known page instead of the first one, so free space
+   * left in earlier pages is not reused. Used to fill freshly created tables.
+   * @param tuple tuple to insert
+   * @param[out] rid the rid of the inserted tuple
+   * @param txn the transaction performing the insert
+   * @return true iff the insert is successful
+   */
+  bool AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -108,11 +122,30 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the ids of all pages of this table, in the order they are chained */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * Read the tuples on pages page_ids[begin, end) in table order. Threads may scan disjoint ranges concurrently.
+   * @param page_ids page ids returned by GetPageIds()
+   * @param begin first position in page_ids to scan
+   * @param end one past the last position in page_ids to scan
+   * @param txn transaction performing the read
+   * @param callback called with every tuple that could be read
+   * @param lock_tuples false reads without tuple locks, for scans that catch up on concurrent changes by other means
+   */
+  void ScanPages(const std::vector<page_id_t> &page_ids, size_t begin, size_t end, Transaction *txn,
+                 const std::function<void(const Tuple &)> &callback, bool lock_tuples = true);
+
  private:
+  bool InsertTupleFrom(page_id_t start_page_id, const Tuple &tuple, RID *rid, Transaction *txn);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  // some page of the chain, pages are never unlinked so walking on from it always reaches the end
+  std::atomic<page_id_t> last_page_id_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -10,7 +10,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 
 #include "common/exception.h"
 #include "common/rid.h"
@@ -50,6 +54,13 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return (root_page_id_ == INVALID_PAGE_ID)
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  if (!MayContain(key)) {
+    return false;
+  }
+  hash_t hash = adaptive_hash_index_ != nullptr ? KeyHash(key) : 0;
+  if (adaptive_hash_index_ != nullptr && GetValueByHash(key, hash, result)) {
+    return true;
+  }
   mutex_.lock();
   if (IsEmpty()) {
     mutex_.unlock();
@@ -65,12 +76,134 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   if (leaf_page->Lookup(key, &value, comparator_)) {
     res = true;
     result->push_back(value);
+    if (adaptive_hash_index_ != nullptr && adaptive_hash_index_->Touch(hash)) {
+      adaptive_hash_index_->Put(hash, page->GetPageId(), leaf_page->KeyIndex(key, comparator_));
+    }
   }
   page->RUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
   return res;
 }
 
+/*
+ * Look the key up at the leaf and slot the adaptive hash index remembers for it.
+ * The entry is only trusted once the leaf is latched: no leaf was freed since it
+ * was written, so the page is still a leaf of this tree, and the slot still holds
+ * the key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::GetValueByHash(const KeyType &key, hash_t hash, std::vector<ValueType> *result) {
+  page_id_t page_id;
+  int slot;
+  uint64_t epoch;
+  if (!adaptive_hash_index_->Get(hash, &page_id, &slot, &epoch)) {
+    return false;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (nullptr == page) {
+    return false;
+  }
+  page->RLatch();
+  LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+  bool res = adaptive_hash_index_->IsCurrent(epoch) && slot < leaf_page->GetSize() &&
+             comparator_(leaf_page->KeyAt(slot), key) == 0;
+  if (res) {
+    result->push_back(leaf_page->GetItem(slot).second);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return res;
+}
+
+/*
+ * Batched point query, keys must be sorted in ascending order.
+ * results[i] receives the value associated with keys[i] (left empty if not found).
+ * The latched leaf is reused while consecutive keys stay within it, and up to
+ * MAX_SIBLING_HOPS right siblings are walked before falling back to a new
+ * root-to-leaf descent.
+ * @return : number of keys found
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                              Transaction *transaction) {
+  results->assign(keys.size(), std::vector<ValueType>{});
+  int found = 0;
+  Page *page = nullptr;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const KeyType &key = keys[i];
+    if (!MayContain(key)) {
+      continue;
+    }
+    if (page != nullptr) {
+      LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+      int hops = 0;
+      while (leaf_page->GetSize() > 0 && comparator_(key, leaf_page->KeyAt(leaf_page->GetSize() - 1)) > 0 &&
+             leaf_page->GetNextPageId() != INVALID_PAGE_ID) {
+        page_id_t next_page_id = leaf_page->GetNextPageId();
+        Page *next_page = nullptr;
+        if (hops < MAX_SIBLING_HOPS) {
+          next_page = buffer_pool_manager_->FetchPage(next_page_id);
+          // 向右加锁可能与合并时向左加锁的写线程死锁, 拿不到锁就重新从根下降
+          if (!next_page->TryRLatch()) {
+            buffer_pool_manager_->UnpinPage(next_page_id, false);
+            next_page = nullptr;
+          }
+        }
+        page->RUnlatch();
+        buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+        page = next_page;
+        if (nullptr == page) {
+          break;
+        }
+        leaf_page = reinterpret_cast<LeafPage *>(page);
+        ++hops;
+      }
+    }
+    if (nullptr == page) {
+      mutex_.lock();
+      if (IsEmpty()) {
+        mutex_.unlock();
+        return found;
+      }
+      page = FindLeafPage(key);
+    }
+    LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+    ValueType value{};
+    if (leaf_page->Lookup(key, &value, comparator_)) {
+      (*results)[i].push_back(value);
+      ++found;
+    }
+  }
+  if (page != nullptr) {
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  return found;
+}
+
+/*
+ * Replace the Bloom filter with one sized for expected_keys and filled with the
+ * keys now in the tree. Removed keys stay in the filter and keys beyond
+ * expected_keys raise its false positive rate, call it again to rebuild.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetBloomFilter(size_t expected_keys, double false_positive_rate) {
+  if (expected_keys == 0) {
+    bloom_filter_.reset();
+    return;
+  }
+  auto bloom_filter = std::make_unique<BloomFilter>(expected_keys, false_positive_rate);
+  for (auto iterator = begin(); !iterator.isEnd(); ++iterator) {
+    bloom_filter->Add(KeyHash((*iterator).first));
+  }
+  bloom_filter_ = std::move(bloom_filter);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetAdaptiveHashIndex(size_t capacity) {
+  adaptive_hash_index_ = capacity == 0 ? nullptr : std::make_unique<AdaptiveHashIndex>(capacity);
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -85,6 +218,13 @@ INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
   // LOG_DEBUG("entering into Insert");
   // LOG_DEBUG("inserting %ld", *((int64_t*)key.data_));
+  // 先登记到过滤器再写叶子, 能在叶子里读到这个键的线程一定也能在过滤器里查到
+  if (bloom_filter_ != nullptr) {
+    bloom_filter_->Add(KeyHash(key));
+  }
+  if (InsertIntoRightmostLeaf(key, value)) {
+    return true;
+  }
   mutex_.lock();
   if (IsEmpty()) {
     StartNewTree(key, value);
@@ -95,6 +235,41 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   // LOG_DEBUG("leaving from Insert");
   return res;
 }
+/*
+ * Fast path for serial keys: a key larger than every key in the tree belongs
+ * to the rightmost leaf, which is cached so the insert skips the descent from
+ * the root. Only taken when the leaf has room, otherwise the regular path
+ * splits it, and only tried while the inserts are appends, so that random
+ * keys do not all queue up on the write latch of the rightmost leaf.
+ * @return: true means the pair was appended here
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoRightmostLeaf(const KeyType &key, const ValueType &value) {
+  page_id_t leaf_page_id = rightmost_leaf_page_id_;
+  if (leaf_page_id == INVALID_PAGE_ID || !last_insert_appended_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(leaf_page_id);
+  if (nullptr == page) {
+    return false;
+  }
+  page->WLatch();
+  // 拿到锁后再确认缓存没变: 期间这个叶子可能已经分裂, 或被合并删除
+  LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+  bool rightmost = rightmost_leaf_page_id_ == leaf_page_id && leaf_page->GetSize() > 0;
+  bool larger = rightmost && comparator_(key, leaf_page->KeyAt(leaf_page->GetSize() - 1)) > 0;
+  bool appended = larger && leaf_page->IsSafe(AccessMode::INSERT);
+  if (appended) {
+    leaf_page->Insert(key, value, comparator_);
+  } else if (rightmost && !larger) {
+    // 不是追加, 之后的插入先走常规路径, 直到又有一次追加
+    last_insert_appended_.store(false, std::memory_order_relaxed);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page_id, appended);
+  return appended;
+}
+
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -112,6 +287,7 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   LeafPage *root_page = reinterpret_cast<LeafPage *>(page);
   root_page->Init(root_page_id_, root_page_id_, leaf_max_size_);
   root_page->Insert(key, value, comparator_);
+  rightmost_leaf_page_id_ = root_page_id_;
   page->WUnlatch();
   // assert(page->GetPinCount() == 1);
   buffer_pool_manager_->UnpinPage(root_page_id_, true);
@@ -140,8 +316,15 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
   int new_size = leaf_page->Insert(key, value, comparator_);
   bool insert_success = old_size < new_size;
   if (insert_success) {
+    // 顺序插入总是落在最右叶子的末尾
+    bool append = leaf_page->GetNextPageId() == INVALID_PAGE_ID &&
+                  comparator_(key, leaf_page->KeyAt(new_size - 1)) == 0;
+    if (last_insert_appended_.load(std::memory_order_relaxed) != append) {
+      last_insert_appended_.store(append, std::memory_order_relaxed);
+    }
     if (new_size == leaf_max_size_) {
-      LeafPage *new_leaf_page = Split(leaf_page);
+      // 追加时只把新键分出去, 旧叶子保持满的
+      LeafPage *new_leaf_page = Split(leaf_page, append);
       KeyType middle_key = new_leaf_page->KeyAt(0);
       InsertIntoParent(leaf_page, middle_key, new_leaf_page, transaction);
       // reinterpret_cast<Page *>(new_leaf_page)->WUnlatch();
@@ -169,7 +352,7 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-N *BPLUSTREE_TYPE::Split(N *node) {
+N *BPLUSTREE_TYPE::Split(N *node, bool append) {
   // LOG_DEBUG("entering into Split");
   page_id_t new_page_id;
   Page *page = buffer_pool_manager_->NewPage(&new_page_id);
@@ -182,9 +365,18 @@ N *BPLUSTREE_TYPE::Split(N *node) {
     new_leaf_page->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
     // new_leaf_page->SetSize(0);
     LeafPage *old_leaf_page = reinterpret_cast<LeafPage *>(node);
-    old_leaf_page->MoveHalfTo(new_leaf_page);
+    if (append) {
+      old_leaf_page->MoveLastToFrontOf(new_leaf_page);
+    } else {
+      old_leaf_page->MoveHalfTo(new_leaf_page);
+    }
+    if (old_leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_page_id_ = new_page_id;
+    }
     new_leaf_page->SetNextPageId(old_leaf_page->GetNextPageId());
+    new_leaf_page->SetPrevPageId(old_leaf_page->GetPageId());
     old_leaf_page->SetNextPageId(new_leaf_page->GetPageId());
+    UpdatePrevPageId(new_leaf_page->GetNextPageId(), new_page_id);
     // LOG_DEBUG("leaving from Split");
     return reinterpret_cast<N *>(new_leaf_page);
   }
@@ -250,6 +442,152 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   buffer_pool_manager_->UnpinPage(parent_page_id, true);
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Split n items into parts runs whose sizes differ by at most one
+ * @return: position of the first item of run i
+ */
+static size_t RunBegin(size_t n, size_t parts, size_t i) { return i * (n / parts) + std::min(i, n % parts); }
+
+/*
+ * Call fn(i) for i in [0, count), the range is cut into contiguous pieces, one per thread
+ */
+template <typename F>
+static void ParallelFor(size_t count, size_t num_threads, const F &fn) {
+  num_threads = std::max<size_t>(1, std::min(num_threads, count));
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = RunBegin(count, num_threads, t); i < RunBegin(count, num_threads, t + 1); ++i) {
+        fn(i);
+      }
+    });
+  }
+  for (size_t i = 0; i < RunBegin(count, num_threads, 1); ++i) {
+    fn(i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+/*
+ * Build the tree bottom up from items sorted by key without duplicates.
+ * Leaves and internal pages are filled up to their max size, the items are
+ * spread evenly so every node stays above its min size. Pages of one level
+ * are written by num_threads threads.
+ * If the tree is not empty the items are inserted one by one instead.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &items, size_t num_threads, Transaction *transaction) {
+  mutex_.lock();
+  if (!IsEmpty() || items.empty()) {
+    mutex_.unlock();
+    for (const auto &item : items) {
+      Insert(item.first, item.second, transaction);
+    }
+    return;
+  }
+  if (bloom_filter_ != nullptr) {
+    for (const auto &item : items) {
+      bloom_filter_->Add(KeyHash(item.first));
+    }
+  }
+  // 先算出每层的节点数并分配好所有页, 这样填充叶子时就知道兄弟和父节点的 page id
+  std::vector<size_t> level_sizes{(items.size() + leaf_max_size_ - 2) / (leaf_max_size_ - 1)};
+  while (level_sizes.back() > 1) {
+    level_sizes.push_back((level_sizes.back() + internal_max_size_ - 2) / (internal_max_size_ - 1));
+  }
+  std::vector<std::vector<page_id_t>> page_ids(level_sizes.size());
+  for (size_t level = 0; level < level_sizes.size(); ++level) {
+    for (size_t i = 0; i < level_sizes[level]; ++i) {
+      page_id_t page_id;
+      if (nullptr == buffer_pool_manager_->NewPage(&page_id)) {
+        mutex_.unlock();
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+      }
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      page_ids[level].push_back(page_id);
+    }
+  }
+  // parent page id of every node on the level below the one being built
+  auto parent_ids = [&](size_t level) {
+    std::vector<page_id_t> parents(level_sizes[level]);
+    if (level + 1 == level_sizes.size()) {
+      parents[0] = page_ids[level][0];
+      return parents;
+    }
+    for (size_t j = 0; j < level_sizes[level + 1]; ++j) {
+      size_t end = RunBegin(level_sizes[level], level_sizes[level + 1], j + 1);
+      for (size_t i = RunBegin(level_sizes[level], level_sizes[level + 1], j); i < end; ++i) {
+        parents[i] = page_ids[level + 1][j];
+      }
+    }
+    return parents;
+  };
+
+  // worker threads can't throw, they flag a failed fetch instead
+  std::atomic<bool> out_of_memory{false};
+  const size_t leaf_count = level_sizes[0];
+  std::vector<KeyType> first_keys(leaf_count);
+  std::vector<page_id_t> parents = parent_ids(0);
+  ParallelFor(leaf_count, num_threads, [&](size_t i) {
+    size_t begin = RunBegin(items.size(), leaf_count, i);
+    size_t end = RunBegin(items.size(), leaf_count, i + 1);
+    page_id_t page_id = page_ids[0][i];
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (nullptr == page) {
+      out_of_memory = true;
+      return;
+    }
+    LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    leaf_page->Init(page_id, parents[i], leaf_max_size_);
+    leaf_page->Populate(&items[begin], static_cast<int>(end - begin));
+    leaf_page->SetPrevPageId(i > 0 ? page_ids[0][i - 1] : INVALID_PAGE_ID);
+    leaf_page->SetNextPageId(i + 1 < leaf_count ? page_ids[0][i + 1] : INVALID_PAGE_ID);
+    first_keys[i] = items[begin].first;
+    buffer_pool_manager_->UnpinPage(page_id, true);
+  });
+
+  for (size_t level = 1; level < level_sizes.size() && !out_of_memory; ++level) {
+    const size_t child_count = level_sizes[level - 1];
+    const size_t node_count = level_sizes[level];
+    std::vector<KeyType> node_first_keys(node_count);
+    parents = parent_ids(level);
+    ParallelFor(node_count, num_threads, [&](size_t j) {
+      size_t begin = RunBegin(child_count, node_count, j);
+      size_t end = RunBegin(child_count, node_count, j + 1);
+      std::vector<std::pair<KeyType, page_id_t>> children;
+      for (size_t i = begin; i < end; ++i) {
+        children.emplace_back(first_keys[i], page_ids[level - 1][i]);
+      }
+      page_id_t page_id = page_ids[level][j];
+      Page *page = buffer_pool_manager_->FetchPage(page_id);
+      if (nullptr == page) {
+        out_of_memory = true;
+        return;
+      }
+      InternalPage *internal_page = reinterpret_cast<InternalPage *>(page->GetData());
+      internal_page->Init(page_id, parents[j], internal_max_size_);
+      internal_page->Populate(children.data(), static_cast<int>(children.size()));
+      node_first_keys[j] = first_keys[begin];
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    });
+    first_keys = std::move(node_first_keys);
+  }
+  if (out_of_memory) {
+    mutex_.unlock();
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+
+  root_page_id_ = page_ids.back()[0];
+  rightmost_leaf_page_id_ = page_ids[0].back();
+  UpdateRootPageId(1);
+  mutex_.unlock();
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -267,7 +605,8 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
     mutex_.unlock();
     return;
   }
-  bool hold_root = FindLeafPagePessimistic(key, AccessMode::DELETE, transaction);
+  AccessMode access_mode = merge_policy_ == MergePolicy::LAZY ? AccessMode::LAZY_DELETE : AccessMode::DELETE;
+  bool hold_root = FindLeafPagePessimistic(key, access_mode, transaction);
   auto page_set = transaction->GetPageSet();
   Page *page = page_set->back();
   // assert(transaction->GetPageSet()->back() == page);
@@ -276,7 +615,9 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   int old_size = leaf_page->GetSize();
   int new_size = leaf_page->RemoveAndDeleteRecord(key, comparator_);
   page_id_t leaf_page_id = leaf_page->GetPageId();
-  if (new_size < leaf_page->GetMinSize()) {
+  // 延迟合并时只回收空的叶子, 不满的叶子留给 Compact
+  int min_size = access_mode == AccessMode::LAZY_DELETE ? 1 : leaf_page->GetMinSize();
+  if (new_size < min_size) {
     CoalesceOrRedistribute(leaf_page, transaction);
     if (hold_root) {
       mutex_.unlock();
@@ -295,6 +636,86 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   // LOG_DEBUG("leaving from Remove");
 }
 
+/*
+ * Background compaction for MergePolicy::LAZY, meant to run when the tree is
+ * quiet. The sparse leaves are collected first, then each one is found again
+ * by key with the usual pessimistic descent and rebalanced like an eager
+ * Remove would have done; a leaf that filled up in between is left alone.
+ * @return : number of pages freed by merges
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::Compact(Transaction *transaction) {
+  size_t freed_before = transaction->GetDeletedPageSet()->size();
+  for (const auto &key : FindSparseLeaves()) {
+    mutex_.lock();
+    if (IsEmpty()) {
+      mutex_.unlock();
+      break;
+    }
+    bool hold_root = FindLeafPagePessimistic(key, AccessMode::DELETE, transaction);
+    Page *page = transaction->GetPageSet()->back();
+    transaction->GetPageSet()->pop_back();
+    LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+    if (!leaf_page->IsRootPage() && leaf_page->GetSize() < leaf_page->GetMinSize()) {
+      CoalesceOrRedistribute(leaf_page, transaction);
+    } else {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    if (hold_root) {
+      mutex_.unlock();
+    }
+    ReleaseAncestorsLock(transaction);
+  }
+  return transaction->GetDeletedPageSet()->size() - freed_before;
+}
+
+/*
+ * Walk the leaf chain under read latches the way IndexIterator does: the next
+ * leaf is only try-latched, on failure the walk restarts from the root with
+ * the last key seen.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+std::vector<KeyType> BPLUSTREE_TYPE::FindSparseLeaves() {
+  std::vector<KeyType> keys;
+  mutex_.lock();
+  if (IsEmpty()) {
+    mutex_.unlock();
+    return keys;
+  }
+  Page *page = FindLeafPage(KeyType{}, true);
+  while (page != nullptr) {
+    LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+    int size = leaf_page->GetSize();
+    if (!leaf_page->IsRootPage() && size > 0 && size < leaf_page->GetMinSize() &&
+        (keys.empty() || comparator_(keys.back(), leaf_page->KeyAt(0)) < 0)) {
+      keys.push_back(leaf_page->KeyAt(0));
+    }
+    page_id_t next_page_id = leaf_page->GetNextPageId();
+    Page *next_page = nullptr;
+    if (next_page_id != INVALID_PAGE_ID) {
+      next_page = buffer_pool_manager_->FetchPage(next_page_id);
+      if (!next_page->TryRLatch()) {
+        buffer_pool_manager_->UnpinPage(next_page_id, false);
+        next_page = nullptr;
+        if (size > 0) {
+          KeyType last_key = leaf_page->KeyAt(size - 1);
+          page->RUnlatch();
+          buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+          std::this_thread::yield();
+          // 可能回到同一个叶子, 上面按键去重
+          page = FindLeafPageForRead(last_key);
+          continue;
+        }
+      }
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = next_page;
+  }
+  return keys;
+}
+
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
@@ -336,7 +757,7 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
     page->WLatch();
     N *sibling_page = reinterpret_cast<N *>(page);
     left_neibor_size = sibling_page->GetSize();
-    if (left_neibor_size + node->GetSize() > node->GetMaxSize()) {
+    if (left_neibor_size + node->GetSize() >= node->GetMaxSize()) {
       Redistribute(sibling_page, node, 1);
       reinterpret_cast<Page *>(parent_page)->WUnlatch();
       // assert(reinterpret_cast<Page *>(parent_page)->GetPinCount() == 1);
@@ -362,7 +783,7 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
     page->WLatch();
     N *sibling_page = reinterpret_cast<N *>(page);
     right_neibor_size = sibling_page->GetSize();
-    if (right_neibor_size + node->GetSize() > node->GetMaxSize()) {
+    if (right_neibor_size + node->GetSize() >= node->GetMaxSize()) {
       Redistribute(sibling_page, node, 0);
       reinterpret_cast<Page *>(parent_page)->WUnlatch();
       // assert(reinterpret_cast<Page *>(parent_page)->GetPinCount() == 1);
@@ -387,17 +808,6 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
   N *neibor_page = reinterpret_cast<N *>(page);
   N *old_node = node;
   Coalesce(&neibor_page, &node, &parent_page, idx, transaction);
-  page_id_t neibor_id = neibor_page->GetPageId();
-  reinterpret_cast<Page *>(neibor_page)->WUnlatch();
-  // assert(reinterpret_cast<Page *>(neibor_page)->GetPinCount() == 1);
-  buffer_pool_manager_->UnpinPage(neibor_id, true);
-
-  page_id_t node_id = node->GetPageId();
-  reinterpret_cast<Page *>(node)->WUnlatch();
-  // assert(reinterpret_cast<Page *>(node)->GetPinCount() == 1);
-  buffer_pool_manager_->UnpinPage(node_id, true);
-  buffer_pool_manager_->DeletePage(node_id);
-  transaction->AddIntoDeletedPageSet(node_id);
   // LOG_DEBUG("leaving from CoalesceOrRedistribute");
   return node == old_node;
 }
@@ -429,8 +839,13 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
     LeafPage *leaf_page = reinterpret_cast<LeafPage *>(*node);
     LeafPage *neibor_page = reinterpret_cast<LeafPage *>(*neighbor_node);
     leaf_page->MoveAllTo(neibor_page);
+    if (leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+      rightmost_leaf_page_id_ = neibor_page->GetPageId();
+    }
     neibor_page->SetNextPageId(leaf_page->GetNextPageId());
+    UpdatePrevPageId(neibor_page->GetNextPageId(), neibor_page->GetPageId());
     (*parent)->Remove(index);
+    ReleaseCoalescedPages(*neighbor_node, *node, transaction);
     bool res = false;
     if ((*parent)->GetSize() < (*parent)->GetMinSize()) {
       res = CoalesceOrRedistribute(*parent, transaction);
@@ -446,6 +861,7 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
   KeyType middle_key = (*parent)->KeyAt(index);
   internal_page->MoveAllTo(neibor_page, middle_key, buffer_pool_manager_);
   (*parent)->Remove(index);
+  ReleaseCoalescedPages(*neighbor_node, *node, transaction);
   bool res = false;
   if ((*parent)->GetSize() < (*parent)->GetMinSize()) {
     res = CoalesceOrRedistribute(*parent, transaction);
@@ -457,6 +873,32 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
   return res;
 }
 
+/*
+ * Unlatch both pages of a finished merge and delete the emptied one. This
+ * happens before the parent is coalesced or redistributed in turn: the parent
+ * latches its left sibling while blocking, and a writer holding that sibling
+ * may be waiting on one of our leaves to fix its prev link.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseCoalescedPages(BPlusTreePage *neighbor_node, BPlusTreePage *node,
+                                           Transaction *transaction) {
+  page_id_t neibor_id = neighbor_node->GetPageId();
+  reinterpret_cast<Page *>(neighbor_node)->WUnlatch();
+  // assert(reinterpret_cast<Page *>(neighbor_node)->GetPinCount() == 1);
+  buffer_pool_manager_->UnpinPage(neibor_id, true);
+
+  page_id_t node_id = node->GetPageId();
+  // 必须在放锁前作废, 之后拿到这个页读锁的查找才能发现它已被删除
+  if (adaptive_hash_index_ != nullptr && node->IsLeafPage()) {
+    adaptive_hash_index_->FreeLeaf();
+  }
+  reinterpret_cast<Page *>(node)->WUnlatch();
+  // assert(reinterpret_cast<Page *>(node)->GetPinCount() == 1);
+  buffer_pool_manager_->UnpinPage(node_id, true);
+  buffer_pool_manager_->DeletePage(node_id);
+  transaction->AddIntoDeletedPageSet(node_id);
+}
+
 /*
  * Redistribute key & value pairs from one page to its sibling page. If index ==
  * 0, move sibling page's first key & value pair into end of input "node",
@@ -588,6 +1030,26 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
   //  sibling_page->MoveLastToFrontOf(internal_page, middle_key, buffer_pool_manager_);
   // LOG_DEBUG("leaving form Redistribute");
 }
+/*
+ * Point the prev link of leaf "page_id" at "prev_page_id" after a split or merge
+ * changed its left neighbour. Latches left to right while the caller still holds
+ * the left page, backward readers only ever try-latch so this cannot deadlock.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::UpdatePrevPageId(page_id_t page_id, page_id_t prev_page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (nullptr == page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  page->WLatch();
+  reinterpret_cast<LeafPage *>(page)->SetPrevPageId(prev_page_id);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -611,6 +1073,10 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
     }
     // 空树
     page_id_t old_root_page_id = old_root_node->GetPageId();
+    rightmost_leaf_page_id_ = INVALID_PAGE_ID;
+    if (adaptive_hash_index_ != nullptr) {
+      adaptive_hash_index_->FreeLeaf();
+    }
     reinterpret_cast<Page *>(old_root_node)->WUnlatch();
     // assert(reinterpret_cast<Page *>(old_root_node)->GetPinCount() == 1);
     buffer_pool_manager_->UnpinPage(old_root_page_id, true);
@@ -650,6 +1116,112 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
   return false;
 }
 
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+/*
+ * Breadth first walk that read latches one page at a time, only while its size
+ * and child page ids are copied out, so writers wait no longer than for a point
+ * lookup. The result is approximate under concurrent writes: a page split or
+ * merged after its parent was read is counted as the walk finds it, and a page
+ * freed or reused meanwhile is skipped. Every internal page is read, of the
+ * leaves about one in 1 / leaf_sample_rate plus the first and the last one for
+ * the key range.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+typename BPLUSTREE_TYPE::Stats BPLUSTREE_TYPE::GetStats(double leaf_sample_rate) {
+  Stats stats;
+  mutex_.lock();
+  if (IsEmpty()) {
+    mutex_.unlock();
+    return stats;
+  }
+  Page *root = buffer_pool_manager_->FetchPage(root_page_id_);
+  root->RLatch();
+  mutex_.unlock();
+  size_t leaf_stride = 1;
+  if (leaf_sample_rate <= 0) {
+    leaf_stride = std::numeric_limits<size_t>::max();
+  } else if (leaf_sample_rate < 1) {
+    leaf_stride = static_cast<size_t>(std::lround(1 / leaf_sample_rate));
+  }
+  size_t sampled_keys = 0;
+  std::vector<page_id_t> level_pages{root->GetPageId()};
+  for (size_t level = 0; !level_pages.empty(); level++) {
+    BPlusTreeLevelStats level_stats;
+    std::vector<page_id_t> next_level_pages;
+    bool kind_known = false;
+    bool leaf_level = false;
+    for (size_t i = 0; i < level_pages.size(); i++) {
+      bool last = i + 1 == level_pages.size();
+      if (leaf_level && i % leaf_stride != 0 && !last) {
+        level_stats.num_pages_++;
+        continue;
+      }
+      Page *page = root;
+      if (level > 0) {
+        page = buffer_pool_manager_->FetchPage(level_pages[i]);
+        if (nullptr == page) {
+          throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+        }
+        page->RLatch();
+      }
+      auto *node = reinterpret_cast<BPlusTreePage *>(page);
+      if (!kind_known && node->GetMaxSize() > 0) {
+        kind_known = true;
+        leaf_level = node->IsLeafPage();
+      }
+      // 读完父节点之后这一页可能已被释放或重用
+      if (node->GetMaxSize() > 0 && node->IsLeafPage() == leaf_level) {
+        level_stats.num_pages_++;
+        AddFill(&level_stats, node);
+        if (leaf_level) {
+          auto *leaf_page = reinterpret_cast<LeafPage *>(node);
+          sampled_keys += leaf_page->GetSize();
+          if (i == 0 && leaf_page->GetSize() > 0) {
+            stats.min_key_ = leaf_page->KeyAt(0);
+          }
+          if (last && leaf_page->GetSize() > 0) {
+            stats.max_key_ = leaf_page->KeyAt(leaf_page->GetSize() - 1);
+          }
+        } else {
+          auto *internal_page = reinterpret_cast<InternalPage *>(node);
+          for (int j = 0; j < internal_page->GetSize(); j++) {
+            next_level_pages.push_back(internal_page->ValueAt(j));
+          }
+        }
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    }
+    if (level_stats.num_sampled_ > 0) {
+      // AddFill 里累加的是总和
+      level_stats.avg_fill_ /= level_stats.num_sampled_;
+      stats.levels_.push_back(level_stats);
+    }
+    level_pages = std::move(next_level_pages);
+  }
+  stats.height_ = static_cast<int>(stats.levels_.size());
+  if (stats.height_ > 0) {
+    const auto &leaves = stats.levels_.back();
+    stats.num_keys_ = sampled_keys * leaves.num_pages_ / leaves.num_sampled_;
+  }
+  return stats;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::AddFill(BPlusTreeLevelStats *level_stats, const BPlusTreePage *node) {
+  double fill = static_cast<double>(node->GetSize()) / node->GetMaxSize();
+  if (level_stats->num_sampled_ == 0) {
+    level_stats->min_fill_ = fill;
+    level_stats->max_fill_ = fill;
+  }
+  level_stats->min_fill_ = std::min(level_stats->min_fill_, fill);
+  level_stats->max_fill_ = std::max(level_stats->max_fill_, fill);
+  level_stats->avg_fill_ += fill;
+  level_stats->num_sampled_++;
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -666,7 +1238,7 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
     return end();
   }
   KeyType key{};
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, FindLeafPage(key, true), 0);
+  return INDEXITERATOR_TYPE(this, buffer_pool_manager_, FindLeafPage(key, true), 0, &comparator_);
 }
 
 /*
@@ -675,22 +1247,77 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return Begin(&key, nullptr); }
+
+/*
+ * Input parameters are the (optional) low and high keys of a range, find the
+ * leaf page that contains the low key (or the left most leaf page), then
+ * construct an index iterator that stops once it passes the high key
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType *low, const KeyType *high, bool low_inclusive,
+                                         bool high_inclusive) {
   mutex_.lock();
   if (IsEmpty()) {
     mutex_.unlock();
     return end();
   }
-  Page *page = FindLeafPage(key);
+  if (nullptr == low) {
+    Page *page = FindLeafPage(KeyType{}, true);
+    return INDEXITERATOR_TYPE(this, buffer_pool_manager_, page, 0, &comparator_, false, high, high_inclusive);
+  }
+  Page *page = FindLeafPage(*low);
   LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
-  int index = leaf_page->KeyIndex(key, comparator_);
-  page_id_t leaf_page_id = leaf_page->GetPageId();
-  if (index != -1) {
-    return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index);
+  int index = leaf_page->KeyIndex(*low, comparator_);
+  if (index == -1) {
+    // 下界大于本页所有的键, 从下一页开始
+    index = leaf_page->GetSize();
+  } else if (!low_inclusive && index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), *low) == 0) {
+    index++;
   }
-  page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(leaf_page_id, false);
-  return end();
+  return INDEXITERATOR_TYPE(this, buffer_pool_manager_, page, index, &comparator_, false, high, high_inclusive, low,
+                            low_inclusive);
+}
+
+/*
+ * Input parameter is void, find the right most leaf page first, then
+ * construct a reverse index iterator starting at the largest key
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::rbegin() { return RBegin(nullptr, nullptr); }
+
+/*
+ * Reverse counterpart of Begin(low, high): start at the largest key that is
+ * not above "high" and walk towards smaller keys until passing "low"
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType *high, const KeyType *low, bool high_inclusive,
+                                          bool low_inclusive) {
+  mutex_.lock();
+  if (IsEmpty()) {
+    mutex_.unlock();
+    return end();
+  }
+  if (nullptr == high) {
+    Page *page = FindLeafPage(KeyType{}, false, true);
+    int index = reinterpret_cast<LeafPage *>(page)->GetSize() - 1;
+    return INDEXITERATOR_TYPE(this, buffer_pool_manager_, page, index, &comparator_, true, low, low_inclusive);
+  }
+  Page *page = FindLeafPage(*high);
+  LeafPage *leaf_page = reinterpret_cast<LeafPage *>(page);
+  int index = leaf_page->KeyIndex(*high, comparator_);
+  if (index == -1) {
+    index = leaf_page->GetSize();
+  }
+  // index 是第一个 >= high 的位置, 包含上界且相等时停在这里, 否则退一格
+  if (!(high_inclusive && index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), *high) == 0)) {
+    index--;
+  }
+  return INDEXITERATOR_TYPE(this, buffer_pool_manager_, page, index, &comparator_, true, low, low_inclusive, high,
+                            high_inclusive);
 }
 
 /*
@@ -706,10 +1333,10 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() { return INDEXITERATOR_TYPE(buffer_pool
  *****************************************************************************/
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
- * the left most leaf page
+ * the left most leaf page, if rightMost flag == true, find the right most one
  */
 INDEX_TEMPLATE_ARGUMENTS
-Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
+Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, bool rightMost) {
   // LOG_DEBUG("entering into FindLeafPage");
   Page *parent_page = buffer_pool_manager_->FetchPage(root_page_id_);
   page_id_t parent_id = root_page_id_;
@@ -722,6 +1349,8 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
     page_id_t child_page_id;
     if (leftMost) {
       child_page_id = internal_page->ValueAt(0);
+    } else if (rightMost) {
+      child_page_id = internal_page->ValueAt(internal_page->GetSize() - 1);
     } else {
       child_page_id = internal_page->Lookup(key, comparator_);
     }
@@ -737,6 +1366,21 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
   return parent_page;
 }
 
+/*
+ * Find the leaf page containing key with its own root lock, the page is
+ * returned read latched. Used by the index iterator to restart a traversal.
+ * @return : nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageForRead(const KeyType &key, bool leftMost, bool rightMost) {
+  mutex_.lock();
+  if (IsEmpty()) {
+    mutex_.unlock();
+    return nullptr;
+  }
+  return FindLeafPage(key, leftMost, rightMost);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key, AccessMode access_mode, Transaction *transaction,
                                              bool leftMost) {
@@ -773,9 +1417,8 @@ Page *BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key, AccessMode acce
     b_plus_page = reinterpret_cast<BPlusTreePage *>(page);
     if (b_plus_page->IsLeafPage()) {
       if (access_mode != AccessMode::SEARCH) {
+        // 保持 pin, 否则换锁的间隙里这个 frame 可能被换出
         page->RUnlatch();
-        buffer_pool_manager_->UnpinPage(child_page_id, false);
-        buffer_pool_manager_->FetchPage(child_page_id);
         page->WLatch();
       }
       parent_page->RUnlatch();
@@ -802,12 +1445,13 @@ bool BPLUSTREE_TYPE::FindLeafPagePessimistic(const KeyType &key, AccessMode acce
     return false;
   }
 
+  bool is_root = leaf_page->IsRootPage();
   page->WUnlatch();
   transaction->GetPageSet()->pop_front();
   // assert(transaction->GetPageSet()->empty());
   buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
 
-  if (!leaf_page->IsRootPage()) {
+  if (!is_root) {
     mutex_.lock();
   }
 
@@ -1002,7 +1646,7 @@ void BPLUSTREE_TYPE::ToString(BPlusTreePage *page, BufferPoolManager *bpm) const
   if (page->IsLeafPage()) {
     LeafPage *leaf = reinterpret_cast<LeafPage *>(page);
     std::cout << "Leaf Page: " << leaf->GetPageId() << " parent: " << leaf->GetParentPageId()
-              << " next: " << leaf->GetNextPageId() << std::endl;
+              << " next: " << leaf->GetNextPageId() << " prev: " << leaf->GetPrevPageId() << std::endl;
     for (int i = 0; i < leaf->GetSize(); i++) {
       std::cout << leaf->KeyAt(i) << ",";
     }
@@ -1029,4 +1673,7 @@ template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTree<IntegerKey<int32_t>, RID, IntegerComparator<int32_t>>;
+template class BPlusTree<IntegerKey<int64_t>, RID, IntegerComparator<int64_t>>;
+
 }  // namespace bustub
@@ -9,6 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <iterator>
+#include <thread>  // NOLINT
+#include <utility>
+
 #include "storage/index/b_plus_tree_index.h"
 
 namespace bustub {
@@ -48,12 +53,106 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
+/*
+ * Sort the probe keys so that the tree can serve neighbouring keys from the
+ * same leaf, then scatter the results back into the caller's order.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  std::vector<KeyType> index_keys(keys.size());
+  std::vector<size_t> order(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    index_keys[i].SetFromKey(keys[i]);
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t lhs, size_t rhs) { return comparator_(index_keys[lhs], index_keys[rhs]) < 0; });
+
+  std::vector<KeyType> sorted_keys;
+  sorted_keys.reserve(keys.size());
+  for (auto i : order) {
+    sorted_keys.push_back(index_keys[i]);
+  }
+  std::vector<std::vector<ValueType>> sorted_results;
+  container_.GetValues(sorted_keys, &sorted_results, transaction);
+
+  results->assign(keys.size(), std::vector<RID>{});
+  for (size_t i = 0; i < order.size(); ++i) {
+    (*results)[order[i]] = std::move(sorted_results[i]);
+  }
+}
+
+/*
+ * Sort every run on its own thread, merge neighbouring runs pairwise until one
+ * is left, then build the tree bottom up from it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(std::vector<std::vector<MappingType>> *runs, size_t num_threads,
+                                    Transaction *transaction) {
+  auto less = [this](const MappingType &lhs, const MappingType &rhs) { return comparator_(lhs.first, rhs.first) < 0; };
+  std::vector<std::thread> threads;
+  for (auto &run : *runs) {
+    threads.emplace_back([&run, &less] { std::stable_sort(run.begin(), run.end(), less); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // std::merge 遇到相等的键先放左边的, 所以表里靠前的元组一直排在前面
+  while (runs->size() > 1) {
+    std::vector<std::vector<MappingType>> merged((runs->size() + 1) / 2);
+    threads.clear();
+    for (size_t i = 0; i < merged.size(); ++i) {
+      threads.emplace_back([runs, &merged, &less, i] {
+        auto &left = (*runs)[2 * i];
+        if (2 * i + 1 == runs->size()) {
+          merged[i] = std::move(left);
+          return;
+        }
+        auto &right = (*runs)[2 * i + 1];
+        merged[i].reserve(left.size() + right.size());
+        std::merge(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(merged[i]), less);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    *runs = std::move(merged);
+  }
+  if (runs->empty()) {
+    return;
+  }
+  auto &items = runs->front();
+  // unique keys only, same as InsertEntry which rejects a later duplicate
+  items.erase(std::unique(items.begin(), items.end(),
+                          [this](const MappingType &lhs, const MappingType &rhs) {
+                            return comparator_(lhs.first, rhs.first) == 0;
+                          }),
+              items.end());
+  container_.BulkLoad(items, num_threads, transaction);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.begin(); }
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) { return container_.Begin(key); }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType *low, const KeyType *high, bool low_inclusive,
+                                                          bool high_inclusive) {
+  return container_.Begin(low, high, low_inclusive, high_inclusive);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetRBeginIterator() { return container_.rbegin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetRBeginIterator(const KeyType *high, const KeyType *low, bool high_inclusive,
+                                                           bool low_inclusive) {
+  return container_.RBegin(high, low, high_inclusive, low_inclusive);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.end(); }
 
@@ -63,4 +162,7 @@ template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class BPlusTreeIndex<IntegerKey<int32_t>, RID, IntegerComparator<int32_t>>;
+template class BPlusTreeIndex<IntegerKey<int64_t>, RID, IntegerComparator<int64_t>>;
+
 }  // namespace bustub
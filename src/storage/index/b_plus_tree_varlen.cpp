@@ -0,0 +1,369 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen.cpp
+//
+// Identification: src/storage/index/b_plus_tree_varlen.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+
+#include "common/exception.h"
+#include "storage/index/b_plus_tree_varlen.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+VarlenIndexIterator::VarlenIndexIterator(VarlenBPlusTree *tree, const VarlenKey *key) : tree_(tree) {
+  tree_->LoadLeaf(key, true, &entries_);
+}
+
+VarlenIndexIterator &VarlenIndexIterator::operator++() {
+  if (isEnd() || ++pos_ < entries_.size()) {
+    return *this;
+  }
+  // 当前叶子的副本已经读完, 用最后一个键从根重新找下一个叶子
+  std::string last_key = std::move(entries_.back().first);
+  VarlenKey key(last_key);
+  tree_->LoadLeaf(&key, false, &entries_);
+  pos_ = 0;
+  return *this;
+}
+
+VarlenBPlusTree::VarlenBPlusTree(std::string name, BufferPoolManager *buffer_pool_manager,
+                                 const VarlenComparator &comparator)
+    : index_name_(std::move(name)), buffer_pool_manager_(buffer_pool_manager), comparator_(comparator) {}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+bool VarlenBPlusTree::GetValue(const VarlenKey &key, std::vector<RID> *result, Transaction *transaction) {
+  latch_.RLock();
+  if (IsEmpty()) {
+    latch_.RUnlock();
+    return false;
+  }
+  std::vector<Page *> path;
+  std::vector<int> child_idxs;
+  FindLeafPath(&key, &path, &child_idxs);
+  auto *leaf = reinterpret_cast<LeafPage *>(path.back()->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found) {
+    result->push_back(leaf->ValueAt(index));
+  }
+  UnpinPath(path, false);
+  latch_.RUnlock();
+  return found;
+}
+
+void VarlenBPlusTree::FindLeafPath(const VarlenKey *key, std::vector<Page *> *path, std::vector<int> *child_idxs) {
+  page_id_t page_id = root_page_id_;
+  while (true) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (nullptr == page) {
+      UnpinPath(*path, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+    }
+    path->push_back(page);
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (node->IsLeafPage()) {
+      return;
+    }
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    // 第一个键无效, 找最后一个 <= key 的位置
+    int index = nullptr == key ? 0 : internal->UpperBound(*key, comparator_, 1) - 1;
+    child_idxs->push_back(index);
+    page_id = internal->ValueAt(index);
+  }
+}
+
+void VarlenBPlusTree::UnpinPath(const std::vector<Page *> &path, bool is_dirty) {
+  for (Page *page : path) {
+    if (nullptr != page) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+    }
+  }
+}
+
+void VarlenBPlusTree::LoadLeaf(const VarlenKey *key, bool inclusive, std::vector<VarlenMappingType> *entries) {
+  entries->clear();
+  latch_.RLock();
+  if (IsEmpty()) {
+    latch_.RUnlock();
+    return;
+  }
+  std::vector<Page *> path;
+  std::vector<int> child_idxs;
+  FindLeafPath(key, &path, &child_idxs);
+  UnpinPath(std::vector<Page *>(path.begin(), path.end() - 1), false);
+  Page *page = path.back();
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = 0;
+  if (nullptr != key) {
+    index = inclusive ? leaf->LowerBound(*key, comparator_) : leaf->UpperBound(*key, comparator_);
+  }
+  while (true) {
+    for (int i = index; i < leaf->GetSize(); ++i) {
+      entries->emplace_back(leaf->KeyAt(i).ToBytes(), leaf->ValueAt(i));
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (!entries->empty() || next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    page = buffer_pool_manager_->FetchPage(next_page_id);
+    leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    index = 0;
+  }
+  latch_.RUnlock();
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+bool VarlenBPlusTree::Insert(const VarlenKey &key, const RID &value, Transaction *transaction) {
+  if (key.size_ > MAX_KEY_SIZE) {
+    return false;
+  }
+  latch_.WLock();
+  if (IsEmpty()) {
+    StartNewTree(key, value);
+    latch_.WUnlock();
+    return true;
+  }
+  std::vector<Page *> path;
+  std::vector<int> child_idxs;
+  FindLeafPath(&key, &path, &child_idxs);
+  auto *leaf = reinterpret_cast<LeafPage *>(path.back()->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+    UnpinPath(path, false);
+    latch_.WUnlock();
+    return false;
+  }
+  if (leaf->HasRoom(key.size_)) {
+    leaf->InsertAt(index, key, value);
+  } else {
+    auto separator = SplitInsert(leaf, index, key, value);
+    InsertIntoParent(&path, static_cast<int>(path.size()) - 2, separator.first, separator.second);
+  }
+  UnpinPath(path, true);
+  latch_.WUnlock();
+  return true;
+}
+
+void VarlenBPlusTree::StartNewTree(const VarlenKey &key, const RID &value) {
+  Page *page = buffer_pool_manager_->NewPage(&root_page_id_);
+  if (nullptr == page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  auto *root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(root_page_id_, IndexPageType::LEAF_PAGE);
+  root->InsertAt(0, key, value);
+  buffer_pool_manager_->UnpinPage(root_page_id_, true);
+  UpdateRootPageId();
+}
+
+/*
+ * path[level] is the parent of the page just split, a new root is created
+ * once the split reaches the top.
+ */
+void VarlenBPlusTree::InsertIntoParent(std::vector<Page *> *path, int level, const std::string &key,
+                                       page_id_t new_page_id) {
+  VarlenKey separator(key);
+  if (level < 0) {
+    page_id_t old_root_id = root_page_id_;
+    Page *page = buffer_pool_manager_->NewPage(&root_page_id_);
+    if (nullptr == page) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(root_page_id_, IndexPageType::INTERNAL_PAGE);
+    root->InsertAt(0, VarlenKey(), old_root_id);
+    root->InsertAt(1, separator, new_page_id);
+    buffer_pool_manager_->UnpinPage(root_page_id_, true);
+    UpdateRootPageId();
+    return;
+  }
+  auto *parent = reinterpret_cast<InternalPage *>((*path)[level]->GetData());
+  int index = parent->UpperBound(separator, comparator_, 1);
+  if (parent->HasRoom(separator.size_)) {
+    parent->InsertAt(index, separator, new_page_id);
+    return;
+  }
+  auto parent_separator = SplitInsert(parent, index, separator, new_page_id);
+  InsertIntoParent(path, level - 1, parent_separator.first, parent_separator.second);
+}
+
+/*
+ * The entries are divided where the bytes of the left part reach half of the
+ * total, so that both pages keep about the same free space.
+ */
+template <typename ValueType>
+std::pair<std::string, page_id_t> VarlenBPlusTree::SplitInsert(BPlusTreeVarlenPage<ValueType> *page, int index,
+                                                               const VarlenKey &key, const ValueType &value) {
+  using Slot = typename BPlusTreeVarlenPage<ValueType>::Slot;
+  std::vector<std::pair<std::string, ValueType>> entries;
+  entries.reserve(page->GetSize() + 1);
+  size_t total_bytes = 0;
+  for (int i = 0; i < page->GetSize(); ++i) {
+    if (i == index) {
+      entries.emplace_back(key.ToBytes(), value);
+    }
+    entries.emplace_back(page->KeyAt(i).ToBytes(), page->ValueAt(i));
+  }
+  if (index == page->GetSize()) {
+    entries.emplace_back(key.ToBytes(), value);
+  }
+  for (const auto &entry : entries) {
+    total_bytes += entry.first.size() + sizeof(Slot);
+  }
+  size_t split = 0;
+  for (size_t left_bytes = 0; split < entries.size() && left_bytes * 2 < total_bytes; ++split) {
+    left_bytes += entries[split].first.size() + sizeof(Slot);
+  }
+  split = std::clamp<size_t>(split, 1, entries.size() - 1);
+
+  page_id_t new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (nullptr == new_page) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  auto *new_node = reinterpret_cast<BPlusTreeVarlenPage<ValueType> *>(new_page->GetData());
+  IndexPageType page_type = page->IsLeafPage() ? IndexPageType::LEAF_PAGE : IndexPageType::INTERNAL_PAGE;
+  page_id_t next_page_id = page->GetNextPageId();
+  page->Init(page->GetPageId(), page_type);
+  new_node->Init(new_page_id, page_type);
+  if (page->IsLeafPage()) {
+    new_node->SetNextPageId(next_page_id);
+    page->SetNextPageId(new_page_id);
+  }
+  for (size_t i = 0; i < split; ++i) {
+    page->InsertAt(i, VarlenKey(entries[i].first), entries[i].second);
+  }
+  for (size_t i = split; i < entries.size(); ++i) {
+    // 内部页右半部分的第一个键上移到父节点, 自己只留一个空键
+    VarlenKey new_key = !page->IsLeafPage() && i == split ? VarlenKey() : VarlenKey(entries[i].first);
+    new_node->InsertAt(i - split, new_key, entries[i].second);
+  }
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  return {entries[split].first, new_page_id};
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+void VarlenBPlusTree::Remove(const VarlenKey &key, Transaction *transaction) {
+  latch_.WLock();
+  if (IsEmpty()) {
+    latch_.WUnlock();
+    return;
+  }
+  std::vector<Page *> path;
+  std::vector<int> child_idxs;
+  FindLeafPath(&key, &path, &child_idxs);
+  auto *leaf = reinterpret_cast<LeafPage *>(path.back()->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  if (index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0) {
+    UnpinPath(path, false);
+    latch_.WUnlock();
+    return;
+  }
+  leaf->RemoveAt(index);
+  Rebalance(&path, child_idxs, static_cast<int>(path.size()) - 1);
+  UnpinPath(path, true);
+  latch_.WUnlock();
+}
+
+/*
+ * An underfull page is merged with its left sibling, or with its right sibling
+ * when it is the first child. When the two do not fit in one page the page is
+ * left as it is. Pages deleted here are unpinned and cleared from path.
+ */
+void VarlenBPlusTree::Rebalance(std::vector<Page *> *path, const std::vector<int> &child_idxs, int level) {
+  Page *page = (*path)[level];
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (level == 0) {
+    if (node->IsLeafPage() && node->GetSize() == 0) {
+      root_page_id_ = INVALID_PAGE_ID;
+    } else if (!node->IsLeafPage() && node->GetSize() == 1) {
+      root_page_id_ = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    } else {
+      return;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    buffer_pool_manager_->DeletePage(page->GetPageId());
+    (*path)[level] = nullptr;
+    UpdateRootPageId();
+    return;
+  }
+  uint32_t used_bytes = node->IsLeafPage() ? reinterpret_cast<LeafPage *>(node)->UsedBytes()
+                                           : reinterpret_cast<InternalPage *>(node)->UsedBytes();
+  if (used_bytes >= MIN_USED_BYTES) {
+    return;
+  }
+  auto *parent = reinterpret_cast<InternalPage *>((*path)[level - 1]->GetData());
+  if (parent->GetSize() < 2) {
+    return;
+  }
+  int index = child_idxs[level - 1];
+  int right_index = index == 0 ? 1 : index;
+  page_id_t sibling_page_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  Page *sibling = buffer_pool_manager_->FetchPage(sibling_page_id);
+  if (nullptr == sibling) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "out of memory");
+  }
+  Page *left = index == 0 ? page : sibling;
+  Page *right = index == 0 ? sibling : page;
+  std::string separator = parent->KeyAt(right_index).ToBytes();
+  bool merged = node->IsLeafPage()
+                    ? Merge(reinterpret_cast<LeafPage *>(left->GetData()), reinterpret_cast<LeafPage *>(right->GetData()),
+                            VarlenKey(separator))
+                    : Merge(reinterpret_cast<InternalPage *>(left->GetData()),
+                            reinterpret_cast<InternalPage *>(right->GetData()), VarlenKey(separator));
+  if (!merged) {
+    buffer_pool_manager_->UnpinPage(sibling_page_id, false);
+    return;
+  }
+  page_id_t right_page_id = right->GetPageId();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+  (*path)[level] = nullptr;
+  buffer_pool_manager_->DeletePage(right_page_id);
+  parent->RemoveAt(right_index);
+  Rebalance(path, child_idxs, level - 1);
+}
+
+template <typename ValueType>
+bool VarlenBPlusTree::Merge(BPlusTreeVarlenPage<ValueType> *left, BPlusTreeVarlenPage<ValueType> *right,
+                            const VarlenKey &separator) {
+  uint32_t extra_bytes = left->IsLeafPage() ? 0 : separator.size_;
+  if (left->FreeBytes() < right->UsedBytes() + extra_bytes) {
+    return false;
+  }
+  int size = left->GetSize();
+  for (int i = 0; i < right->GetSize(); ++i) {
+    // 内部页右边第一个键是空的, 用父节点里的分隔键补上
+    VarlenKey key = !left->IsLeafPage() && i == 0 ? separator : right->KeyAt(i);
+    left->InsertAt(size + i, key, right->ValueAt(i));
+  }
+  if (left->IsLeafPage()) {
+    left->SetNextPageId(right->GetNextPageId());
+  }
+  return true;
+}
+
+void VarlenBPlusTree::UpdateRootPageId() {
+  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  // create a new record<index_name + root_page_id> in header_page the first time
+  if (!header_page->UpdateRecord(index_name_, root_page_id_)) {
+    header_page->InsertRecord(index_name_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+}  // namespace bustub
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_index.cpp
+//
+// Identification: src/storage/index/b_plus_tree_varlen_index.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+
+#include "common/exception.h"
+#include "storage/index/b_plus_tree_varlen_index.h"
+
+namespace bustub {
+
+VarlenBPlusTreeIndex::VarlenBPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
+    : Index(metadata),
+      comparator_(metadata->GetKeySchema()),
+      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+
+void VarlenBPlusTreeIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  if (key.GetLength() > VarlenBPlusTree::MAX_KEY_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "index key of " + std::to_string(key.GetLength()) +
+                                                     " bytes is longer than " +
+                                                     std::to_string(VarlenBPlusTree::MAX_KEY_SIZE));
+  }
+  container_.Insert(VarlenKey(key), rid, transaction);
+}
+
+void VarlenBPlusTreeIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Remove(VarlenKey(key), transaction);
+}
+
+void VarlenBPlusTreeIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  container_.GetValue(VarlenKey(key), result, transaction);
+}
+
+VarlenIndexIterator VarlenBPlusTreeIndex::GetBeginIterator() { return container_.Begin(); }
+
+VarlenIndexIterator VarlenBPlusTreeIndex::GetBeginIterator(const Tuple &key) {
+  return container_.Begin(VarlenKey(key));
+}
+
+}  // namespace bustub
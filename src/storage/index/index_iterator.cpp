@@ -2,7 +2,9 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <thread>  // NOLINT
 
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
@@ -31,6 +33,28 @@ INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, Page *
   }
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BPlusTree<KeyType, ValueType, KeyComparator> *tree,
+                                  BufferPoolManager *buffer_pool_manager, Page *leaf, int index_in_leaf,
+                                  const KeyComparator *comparator, bool reverse, const KeyType *stop_key,
+                                  bool stop_inclusive, const KeyType *start_key, bool start_inclusive)
+    : IndexIterator(buffer_pool_manager, leaf, index_in_leaf) {
+  tree_ = tree;
+  comparator_ = comparator;
+  reverse_ = reverse;
+  if (stop_key != nullptr) {
+    has_stop_key_ = true;
+    stop_key_ = *stop_key;
+    stop_inclusive_ = stop_inclusive;
+  }
+  if (start_key != nullptr) {
+    has_resume_key_ = true;
+    resume_key_ = *start_key;
+    resume_inclusive_ = start_inclusive;
+  }
+  AdjustPosition();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::isEnd() { return leaf_ == nullptr && index_in_leaf_ == -1; }
 
@@ -39,35 +63,111 @@ const MappingType &INDEXITERATOR_TYPE::operator*() { return leaf_->GetItem(index
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-  index_in_leaf_++;
-  if (index_in_leaf_ == leaf_->GetSize()) {
-    page_id_t next_page_id = leaf_->GetNextPageId();
-    if (next_page_id == INVALID_PAGE_ID) {
-      reinterpret_cast<Page *>(leaf_)->RUnlatch();
-      buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
-      leaf_ = nullptr;
-      // leaf_id_ = INVALID_PAGE_ID;
-      index_in_leaf_ = -1;
-    } else {
-      Page *page = buffer_pool_manager_->FetchPage(next_page_id);
+  if (reverse_) {
+    index_in_leaf_--;
+  } else {
+    index_in_leaf_++;
+  }
+  AdjustPosition();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::AdjustPosition() {
+  while (leaf_ != nullptr && (index_in_leaf_ < 0 || index_in_leaf_ >= leaf_->GetSize())) {
+    page_id_t sibling_page_id = reverse_ ? leaf_->GetPrevPageId() : leaf_->GetNextPageId();
+    if (sibling_page_id == INVALID_PAGE_ID) {
+      ReleaseLeaf();
+      break;
+    }
+    // 持有当前页的读锁去 try 兄弟页: 写线程会反方向加锁, 阻塞等待可能死锁
+    Page *page = buffer_pool_manager_->FetchPage(sibling_page_id);
+    if (page->TryRLatch()) {
+      SaveResumeKey();
       reinterpret_cast<Page *>(leaf_)->RUnlatch();
       buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
-      if (page->TryRLatch()) {
-        leaf_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page);
-        // leaf_id_ = leaf_->GetPageId();
-        index_in_leaf_ = 0;
-      } else {
-        reinterpret_cast<Page *>(leaf_)->RUnlatch();
-        buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
-        buffer_pool_manager_->UnpinPage(next_page_id, false);
-        leaf_ = nullptr;
-        // leaf_id_ = INVALID_PAGE_ID;
-        index_in_leaf_ = -1;
-        throw std::exception();
-      }
+      leaf_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page);
+      // leaf_id_ = leaf_->GetPageId();
+      index_in_leaf_ = reverse_ ? leaf_->GetSize() - 1 : 0;
+      continue;
+    }
+    buffer_pool_manager_->UnpinPage(sibling_page_id, false);
+    if (nullptr == tree_) {
+      ReleaseLeaf();
+      throw std::exception();
+    }
+    Restart();
+  }
+  if (leaf_ != nullptr && has_stop_key_) {
+    int cmp = (*comparator_)(leaf_->KeyAt(index_in_leaf_), stop_key_);
+    if (reverse_) {
+      cmp = -cmp;
+    }
+    if (cmp > 0 || (cmp == 0 && !stop_inclusive_)) {
+      ReleaseLeaf();
     }
   }
-  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Restart() {
+  // 当前页已经读完, 记下边界键后放掉所有锁, 从根重新找
+  // LAZY 合并策略下当前页可能是空的, 这时用之前离开的非空页的边界键
+  SaveResumeKey();
+  ReleaseLeaf();
+  std::this_thread::yield();
+  if (!has_resume_key_) {
+    // 还没离开过起始页且起始页是空的: 从树的一端重新开始
+    Page *page = tree_->FindLeafPageForRead(KeyType{}, !reverse_, reverse_);
+    if (nullptr != page) {
+      leaf_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page);
+      index_in_leaf_ = reverse_ ? leaf_->GetSize() - 1 : 0;
+    }
+    return;
+  }
+  Page *page = tree_->FindLeafPageForRead(resume_key_);
+  if (nullptr == page) {
+    return;
+  }
+  leaf_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page);
+  // first index with key >= boundary
+  int index = leaf_->KeyIndex(resume_key_, *comparator_);
+  if (index == -1) {
+    index = leaf_->GetSize();
+  }
+  bool equal = index < leaf_->GetSize() && (*comparator_)(leaf_->KeyAt(index), resume_key_) == 0;
+  if (reverse_) {
+    index_in_leaf_ = equal && resume_inclusive_ ? index : index - 1;
+  } else {
+    index_in_leaf_ = equal && !resume_inclusive_ ? index + 1 : index;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SaveResumeKey() {
+  if (leaf_->GetSize() == 0) {
+    return;
+  }
+  KeyType key = reverse_ ? leaf_->KeyAt(0) : leaf_->KeyAt(leaf_->GetSize() - 1);
+  // 只往扫描方向推进: Restart 后落到的叶子可能全是续扫键之前的键, 用它的边界键会倒退, 重复返回
+  int cmp = has_resume_key_ ? (*comparator_)(key, resume_key_) : 1;
+  if (reverse_) {
+    cmp = has_resume_key_ ? -cmp : 1;
+  }
+  if (cmp >= 0) {
+    has_resume_key_ = true;
+    resume_key_ = key;
+    resume_inclusive_ = false;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::ReleaseLeaf() {
+  reinterpret_cast<Page *>(leaf_)->RUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+  leaf_ = nullptr;
+  // leaf_id_ = INVALID_PAGE_ID;
+  index_in_leaf_ = -1;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -89,6 +189,15 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(const INDEXITERATOR_TYPE &rhs)
       // leaf_id_ = INVALID_PAGE_ID;
       index_in_leaf_ = INVALID_PAGE_ID;
     }
+    tree_ = rhs.tree_;
+    comparator_ = rhs.comparator_;
+    reverse_ = rhs.reverse_;
+    has_stop_key_ = rhs.has_stop_key_;
+    stop_key_ = rhs.stop_key_;
+    stop_inclusive_ = rhs.stop_inclusive_;
+    has_resume_key_ = rhs.has_resume_key_;
+    resume_key_ = rhs.resume_key_;
+    resume_inclusive_ = rhs.resume_inclusive_;
   }
   return *this;
 }
@@ -103,6 +212,15 @@ INDEXITERATOR_TYPE::IndexIterator(const IndexIterator &rhs) {
     // leaf_id_ = leaf_->GetPageId();
     index_in_leaf_ = rhs.index_in_leaf_;
   }
+  tree_ = rhs.tree_;
+  comparator_ = rhs.comparator_;
+  reverse_ = rhs.reverse_;
+  has_stop_key_ = rhs.has_stop_key_;
+  stop_key_ = rhs.stop_key_;
+  stop_inclusive_ = rhs.stop_inclusive_;
+  has_resume_key_ = rhs.has_resume_key_;
+  resume_key_ = rhs.resume_key_;
+  resume_inclusive_ = rhs.resume_inclusive_;
 }
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
@@ -115,4 +233,8 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<IntegerKey<int32_t>, RID, IntegerComparator<int32_t>>;
+
+template class IndexIterator<IntegerKey<int64_t>, RID, IntegerComparator<int64_t>>;
+
 }  // namespace bustub
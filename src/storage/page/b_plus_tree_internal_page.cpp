@@ -9,9 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
+#include "storage/index/simd_key_search.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -76,17 +78,7 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { return arra
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
   int size = GetSize();
-  int lo = 1;
-  int hi = size;
-  int mi;
-  while (lo < hi) {
-    mi = (lo + hi) >> 1;
-    if (comparator(key, array[mi].first) < 0) {
-      hi = mi;
-    } else {
-      lo = mi + 1;
-    }
-  }
+  int lo = KeyUpperBound(array, 1, size, key, comparator);
   return array[lo - 1].second;
   //  int i;
   //  for (i = 1; i < size; ++i) {
@@ -228,6 +220,16 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient,
   IncreaseSize(-GetSize());
 }
 
+/*
+ * Fill an empty page with sorted items, used when bulk loading the tree. The
+ * children are expected to already point at this page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Populate(const MappingType *items, int size) {
+  std::copy(items, items + size, array);
+  SetSize(size);
+}
+
 /*****************************************************************************
  * REDISTRIBUTE
  *****************************************************************************/
@@ -305,4 +307,7 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+template class BPlusTreeInternalPage<IntegerKey<int32_t>, page_id_t, IntegerComparator<int32_t>>;
+template class BPlusTreeInternalPage<IntegerKey<int64_t>, page_id_t, IntegerComparator<int64_t>>;
 }  // namespace bustub
@@ -9,10 +9,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
 #include "common/exception.h"
 #include "common/rid.h"
+#include "storage/index/simd_key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -33,6 +35,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, in
   SetParentPageId(parent_id);
   SetMaxSize(max_size);
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
 }
 
 /**
@@ -44,6 +47,15 @@ page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { return next_page_i
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
+/**
+ * Helper methods to set/get prev page id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const { return prev_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) { prev_page_id_ = prev_page_id; }
+
 /**
  * Helper method to find the first index i so that array[i].first >= key
  * NOTE: This method is only used when generating index iterator
@@ -58,17 +70,7 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator
   //    }
   //  }
   //  return -1;
-  int lo = 0;
-  int hi = size;
-  int mi;
-  while (lo < hi) {
-    mi = (lo + hi) >> 1;
-    if (comparator(key, array[mi].first) < 0) {
-      hi = mi;
-    } else {
-      lo = mi + 1;
-    }
-  }
+  int lo = KeyUpperBound(array, 0, size, key, comparator);
   if (lo > 0) {
     if (comparator(key, array[lo - 1].first) == 0) {
       return lo - 1;
@@ -114,17 +116,7 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
     return 1;
   }
 
-  int lo = 0;
-  int hi = size;
-  int mi;
-  while (lo < hi) {
-    mi = (lo + hi) >> 1;
-    if (comparator(key, array[mi].first) < 0) {
-      hi = mi;
-    } else {
-      lo = mi + 1;
-    }
-  }
+  int lo = KeyUpperBound(array, 0, size, key, comparator);
   if (lo > 0 && comparator(key, array[lo - 1].first) == 0) {
     return size;
   }
@@ -187,17 +179,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const {
   int size = GetSize();
-  int lo = 0;
-  int hi = size;
-  int mi;
-  while (lo < hi) {
-    mi = (lo + hi) >> 1;
-    if (comparator(key, array[mi].first) < 0) {
-      hi = mi;
-    } else {
-      lo = mi + 1;
-    }
-  }
+  int lo = KeyUpperBound(array, 0, size, key, comparator);
   if (lo > 0 && comparator(key, array[lo - 1].first) == 0) {
     *value = array[lo - 1].second;
     return true;
@@ -237,17 +219,7 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
   //  }
   //  return size;
 
-  int lo = 0;
-  int hi = size;
-  int mi;
-  while (lo < hi) {
-    mi = (lo + hi) >> 1;
-    if (comparator(key, array[mi].first) < 0) {
-      hi = mi;
-    } else {
-      lo = mi + 1;
-    }
-  }
+  int lo = KeyUpperBound(array, 0, size, key, comparator);
   int delete_pos;
   if (lo > 0) {
     if (comparator(key, array[lo - 1].first) == 0) {
@@ -277,6 +249,15 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
   IncreaseSize(-size);
 }
 
+/*
+ * Fill an empty page with sorted items, used when bulk loading the tree
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Populate(const MappingType *items, int size) {
+  std::copy(items, items + size, array);
+  SetSize(size);
+}
+
 /*****************************************************************************
  * REDISTRIBUTE
  *****************************************************************************/
@@ -331,4 +312,7 @@ template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTreeLeafPage<IntegerKey<int32_t>, RID, IntegerComparator<int32_t>>;
+template class BPlusTreeLeafPage<IntegerKey<int64_t>, RID, IntegerComparator<int64_t>>;
 }  // namespace bustub
@@ -56,7 +56,10 @@ void BPlusTreePage::SetPageId(page_id_t page_id) { page_id_ = page_id; }
 
 bool BPlusTreePage::IsSafe(AccessMode access_mode) const {
   int size = GetSize();
-  if (access_mode == AccessMode::DELETE) {
+  if (access_mode == AccessMode::LAZY_DELETE && IsLeafPage()) {
+    return size > 1;
+  }
+  if (access_mode == AccessMode::DELETE || access_mode == AccessMode::LAZY_DELETE) {
     if ((IsRootPage() && size > 2) || size > GetMinSize()) {
       return true;
     }
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_varlen_page.cpp
+//
+// Identification: src/storage/page/b_plus_tree_varlen_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cassert>
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/page/b_plus_tree_varlen_page.h"
+
+namespace bustub {
+
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::Init(page_id_t page_id, IndexPageType page_type) {
+  static_assert(sizeof(BPlusTreeVarlenPage) == VARLEN_PAGE_HEADER_SIZE, "varlen page header size mismatch");
+  SetPageType(page_type);
+  SetSize(0);
+  SetMaxSize(0);
+  // 不维护父指针, VarlenBPlusTree 下降时自己记录路径
+  SetParentPageId(INVALID_PAGE_ID);
+  SetPageId(page_id);
+  SetLSN();
+  next_page_id_ = INVALID_PAGE_ID;
+  heap_begin_ = PAGE_SIZE;
+  key_bytes_ = 0;
+}
+
+template <typename ValueType>
+VarlenKey BPlusTreeVarlenPage<ValueType>::KeyAt(int index) const {
+  const Slot &slot = slots_[index];
+  return VarlenKey(reinterpret_cast<const char *>(this) + slot.offset_, slot.length_);
+}
+
+template <typename ValueType>
+int BPlusTreeVarlenPage<ValueType>::LowerBound(const VarlenKey &key, const VarlenComparator &comparator,
+                                               int begin) const {
+  int left = begin;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(KeyAt(mid), key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+template <typename ValueType>
+int BPlusTreeVarlenPage<ValueType>::UpperBound(const VarlenKey &key, const VarlenComparator &comparator,
+                                               int begin) const {
+  int left = begin;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(KeyAt(mid), key) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+/*
+ * The key goes to the gap between slot array and heap; when the gap is too
+ * small but the holes left by removed keys make up for it, compact first.
+ */
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::InsertAt(int index, const VarlenKey &key, const ValueType &value) {
+  assert(HasRoom(key.size_));
+  int size = GetSize();
+  uint32_t slots_end = VARLEN_PAGE_HEADER_SIZE + (size + 1) * sizeof(Slot);
+  if (heap_begin_ < slots_end + key.size_) {
+    Compact();
+  }
+  heap_begin_ -= key.size_;
+  if (key.size_ > 0) {
+    memcpy(reinterpret_cast<char *>(this) + heap_begin_, key.data_, key.size_);
+  }
+  memmove(slots_ + index + 1, slots_ + index, (size - index) * sizeof(Slot));
+  slots_[index].offset_ = static_cast<uint16_t>(heap_begin_);
+  slots_[index].length_ = static_cast<uint16_t>(key.size_);
+  slots_[index].value_ = value;
+  key_bytes_ += key.size_;
+  IncreaseSize(1);
+}
+
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::RemoveAt(int index) {
+  int size = GetSize();
+  key_bytes_ -= slots_[index].length_;
+  memmove(slots_ + index, slots_ + index + 1, (size - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+  if (size == 1) {
+    heap_begin_ = PAGE_SIZE;
+  }
+}
+
+template <typename ValueType>
+void BPlusTreeVarlenPage<ValueType>::Compact() {
+  char heap[PAGE_SIZE];
+  uint32_t begin = PAGE_SIZE;
+  char *page = reinterpret_cast<char *>(this);
+  for (int i = 0; i < GetSize(); ++i) {
+    Slot &slot = slots_[i];
+    begin -= slot.length_;
+    memcpy(heap + begin, page + slot.offset_, slot.length_);
+    slot.offset_ = static_cast<uint16_t>(begin);
+  }
+  memcpy(page + begin, heap + begin, PAGE_SIZE - begin);
+  heap_begin_ = begin;
+}
+
+template class BPlusTreeVarlenPage<RID>;
+template class BPlusTreeVarlenPage<page_id_t>;
+
+}  // namespace bustub
@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "storage/page/hash_table_block_page.h"
 #include "storage/index/generic_key.h"
 
@@ -17,30 +21,70 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 KeyType HASH_TABLE_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 ValueType HASH_TABLE_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const {
-  return {};
+  return array_[bucket_ind].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value) {
-  return false;
+bool HASH_TABLE_BLOCK_TYPE::Insert(slot_offset_t bucket_ind, const KeyType &key, const ValueType &value,
+                                   uint8_t tag) {
+  static_assert(sizeof(HashTableBlockPage) + BLOCK_ARRAY_SIZE * sizeof(MappingType) <= PAGE_SIZE,
+                "block page does not fit in a page");
+  char mask = static_cast<char>(1 << (bucket_ind % 8));
+  // 抢占 occupied 位成功后才写入, 写完再置 readable, 读者不会看到写了一半的键值对
+  if ((occupied_[bucket_ind / 8].fetch_or(mask) & mask) != 0) {
+    return false;
+  }
+  array_[bucket_ind] = MappingType(key, value);
+  tags_[bucket_ind] = tag;
+  readable_[bucket_ind / 8].fetch_or(mask);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {}
+void HASH_TABLE_BLOCK_TYPE::Remove(slot_offset_t bucket_ind) {
+  // occupied 位保留作墓碑, 线性探测不会在这里提前停下
+  readable_[bucket_ind / 8].fetch_and(static_cast<char>(~(1 << (bucket_ind % 8))));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const {
-  return false;
+  return (occupied_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BLOCK_TYPE::IsReadable(slot_offset_t bucket_ind) const {
-  return false;
+  return (readable_[bucket_ind / 8].load() & (1 << (bucket_ind % 8))) != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::MatchTag(slot_offset_t group_ind, uint8_t tag) const {
+#if defined(__AVX2__)
+  __m256i tags = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tags_ + group_ind));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(tags, _mm256_set1_epi8(tag))));
+#elif defined(__SSE2__)
+  __m128i tags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tags_ + group_ind));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(tags, _mm_set1_epi8(tag))));
+#else
+  uint32_t match = 0;
+  for (slot_offset_t i = 0; i < TAG_GROUP_SIZE; i++) {
+    match |= static_cast<uint32_t>(tags_[group_ind + i] == tag) << i;
+  }
+  return match;
+#endif
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BLOCK_TYPE::OccupiedMask(slot_offset_t group_ind) const {
+  uint32_t mask = 0;
+  for (slot_offset_t i = 0; i < TAG_GROUP_SIZE / 8; i++) {
+    mask |= static_cast<uint32_t>(static_cast<unsigned char>(occupied_[group_ind / 8 + i].load())) << (8 * i);
+  }
+  return mask;
 }
 
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
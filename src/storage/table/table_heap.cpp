@@ -22,7 +22,8 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      last_page_id_(first_page_id) {}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -34,15 +35,24 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  last_page_id_ = first_page_id_;
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
+  return InsertTupleFrom(first_page_id_, tuple, rid, txn);
+}
+
+bool TableHeap::AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
+  return InsertTupleFrom(last_page_id_, tuple, rid, txn);
+}
+
+bool TableHeap::InsertTupleFrom(page_id_t start_page_id, const Tuple &tuple, RID *rid, Transaction *txn) {
   if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(start_page_id));
   if (cur_page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
@@ -79,6 +89,7 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
+      last_page_id_ = next_page_id;
     }
   }
   // This line has caused most of us to double-take and "whoa double unlatch".
@@ -189,6 +200,44 @@ TableIterator TableHeap::Begin(Transaction *txn) {
   return TableIterator(this, rid, txn);
 }
 
+std::vector<page_id_t> TableHeap::GetPageIds() {
+  std::vector<page_id_t> page_ids;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    page_ids.push_back(page_id);
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page->RLatch();
+    auto next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return page_ids;
+}
+
+void TableHeap::ScanPages(const std::vector<page_id_t> &page_ids, size_t begin, size_t end, Transaction *txn,
+                          const std::function<void(const Tuple &)> &callback, bool lock_tuples) {
+  for (size_t i = begin; i < end; ++i) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_ids[i]));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return;
+    }
+    page->RLatch();
+    RID rid;
+    bool has_tuple = page->GetFirstTupleRid(&rid);
+    while (has_tuple) {
+      Tuple tuple;
+      if (page->GetTuple(rid, &tuple, txn, lock_tuples ? lock_manager_ : nullptr)) {
+        callback(tuple);
+      }
+      has_tuple = page->GetNextTupleRid(rid, &rid);
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_ids[i], false);
+  }
+}
+
 TableIterator TableHeap::End() { return TableIterator(this, RID(INVALID_PAGE_ID, 0), nullptr); }
 
 }  // namespace bustub
@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/*
+ * Puts the hashes of the keys 0, stride, 2 * stride, ... into 1024 buckets, once by
+ * the low 10 bits and once by the top 10 bits, and expects a chi-squared value
+ * close to that of a uniform hash (1023 degrees of freedom, mean 1023, sd ~45).
+ */
+static void CheckBuckets(int64_t stride) {
+  const int num_buckets = 1024;
+  const int num_keys = 64 * num_buckets;
+  std::vector<int> low(num_buckets);
+  std::vector<int> high(num_buckets);
+  std::unordered_set<hash_t> hashes;
+  for (int64_t i = 0; i < num_keys; i++) {
+    int64_t key = i * stride;
+    hash_t hash = HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(key));
+    hashes.insert(hash);
+    low[hash % num_buckets]++;
+    high[hash >> 54]++;
+  }
+  EXPECT_EQ(num_keys, hashes.size());
+
+  double expected = static_cast<double>(num_keys) / num_buckets;
+  for (const auto &buckets : {low, high}) {
+    double chi_squared = 0;
+    for (int count : buckets) {
+      chi_squared += (count - expected) * (count - expected) / expected;
+    }
+    EXPECT_LT(chi_squared, 1023 + 6 * 45) << "stride " << stride;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, DistributionTest) {
+  CheckBuckets(1);
+  // keys that differ only in their high bytes
+  CheckBuckets(int64_t{1} << 40);
+  CheckBuckets(10000);
+}
+
+/*
+ * Flipping any one input bit flips each output bit with probability 1/2, so
+ * about 32 of the 64 output bits.
+ */
+// NOLINTNEXTLINE
+TEST(HashUtilTest, AvalancheTest) {
+  std::mt19937_64 gen(15445);
+  for (size_t length : {4, 8, 13, 32}) {
+    std::vector<char> bytes(length);
+    int64_t flipped = 0;
+    int trials = 0;
+    for (int round = 0; round < 200; round++) {
+      for (auto &byte : bytes) {
+        byte = static_cast<char>(gen());
+      }
+      hash_t hash = HashUtil::HashBytes(bytes.data(), length);
+      for (size_t bit = 0; bit < 8 * length; bit++) {
+        bytes[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+        flipped += __builtin_popcountll(hash ^ HashUtil::HashBytes(bytes.data(), length));
+        bytes[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+        trials++;
+      }
+    }
+    double mean = static_cast<double>(flipped) / trials;
+    EXPECT_NEAR(32.0, mean, 0.5) << "length " << length;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashValueTest) {
+  // integers of every width hash alike, so equal values of different types join
+  Value small = ValueFactory::GetSmallIntValue(7);
+  Value big = ValueFactory::GetBigIntValue(7);
+  EXPECT_EQ(HashUtil::HashValue(&small), HashUtil::HashValue(&big));
+  Value a = ValueFactory::GetIntegerValue(1);
+  Value b = ValueFactory::GetIntegerValue(2);
+  EXPECT_NE(HashUtil::HashValue(&a), HashUtil::HashValue(&b));
+
+  Value s1 = ValueFactory::GetVarcharValue("hash join");
+  Value s2 = ValueFactory::GetVarcharValue("hash join");
+  Value s3 = ValueFactory::GetVarcharValue("hash joio");
+  EXPECT_EQ(HashUtil::HashValue(&s1), HashUtil::HashValue(&s2));
+  EXPECT_NE(HashUtil::HashValue(&s1), HashUtil::HashValue(&s3));
+
+  // combining is order dependent
+  hash_t ha = HashUtil::HashValue(&a);
+  hash_t hb = HashUtil::HashValue(&b);
+  EXPECT_NE(HashUtil::CombineHashes(ha, hb), HashUtil::CombineHashes(hb, ha));
+}
+
+/*
+ * Microbenchmark: the old byte at a time loop against HashBytes, over keys of
+ * GenericKey sizes.
+ */
+static hash_t ByteAtATimeHash(const char *bytes, size_t length) {
+  hash_t hash = length;
+  for (size_t i = 0; i < length; ++i) {
+    hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  }
+  return hash;
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, DISABLED_Benchmark) {
+  const int rounds = 1000000;
+  std::mt19937_64 gen(15445);
+  std::vector<char> bytes(64 * 1024);
+  for (auto &byte : bytes) {
+    byte = static_cast<char>(gen());
+  }
+  for (size_t length : {4, 8, 16, 32, 64}) {
+    hash_t checksum[2] = {0, 0};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      checksum[0] += ByteAtATimeHash(bytes.data() + (i * 64) % (bytes.size() - 64), length);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      checksum[1] += HashUtil::HashBytes(bytes.data() + (i * 64) % (bytes.size() - 64), length);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto old_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count();
+    auto new_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count();
+    printf("%zu bytes: byte at a time %.2f ns/hash, word at a time %.2f ns/hash (checksums %zu %zu)\n", length,
+           static_cast<double>(old_ns) / rounds, static_cast<double>(new_ns) / rounds, checksum[0], checksum[1]);
+  }
+}
+
+}  // namespace bustub
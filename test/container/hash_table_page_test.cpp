@@ -23,7 +23,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
+TEST(HashTablePageTest, HeaderPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -61,7 +61,7 @@ TEST(HashTablePageTest, DISABLED_HeaderPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
+TEST(HashTablePageTest, BlockPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManager(5, disk_manager);
 
@@ -111,4 +111,40 @@ TEST(HashTablePageTest, DISABLED_BlockPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BlockPageTagTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(5, disk_manager);
+
+  page_id_t block_page_id = INVALID_PAGE_ID;
+  auto block_page =
+      reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
+
+  // tag every third slot of the second group with 0xab, the others with their index
+  slot_offset_t group_ind = TAG_GROUP_SIZE;
+  uint32_t expected = 0;
+  for (unsigned i = 0; i < TAG_GROUP_SIZE; i++) {
+    uint8_t tag = i % 3 == 0 ? 0xab : i;
+    EXPECT_TRUE(block_page->Insert(group_ind + i, i, i, tag));
+    if (i % 3 == 0) {
+      expected |= 1U << i;
+    }
+  }
+  EXPECT_EQ(expected, block_page->MatchTag(group_ind, 0xab));
+  EXPECT_EQ(1U << 5, block_page->MatchTag(group_ind, 5));
+  EXPECT_EQ(0, block_page->MatchTag(group_ind, 0xcd));
+
+  // removed slots stay occupied
+  block_page->Remove(group_ind + 1);
+  EXPECT_EQ(0, block_page->OccupiedMask(0));
+  EXPECT_EQ(TAG_GROUP_SIZE == 32 ? ~0U : (1U << TAG_GROUP_SIZE) - 1, block_page->OccupiedMask(group_ind));
+  EXPECT_EQ(0xab, (HashTableBlockPage<int, int, IntComparator>::TagOf(0xab00000000000001)));
+
+  bpm->UnpinPage(block_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
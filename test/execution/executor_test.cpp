@@ -10,9 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <limits>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -22,18 +28,25 @@
 #include "concurrency/transaction_manager.h"
 #include "execution/execution_engine.h"
 #include "execution/executor_context.h"
+#include "execution/executor_factory.h"
 #include "execution/executors/aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/morsel_scheduler.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/delete_plan.h"
+#include "execution/plans/hash_join_plan.h"
 #include "execution/plans/index_scan_plan.h"
 #include "execution/plans/limit_plan.h"
+#include "execution/plans/merge_join_plan.h"
 #include "execution/plans/nested_index_join_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
 #include "execution/plans/update_plan.h"
 #include "gtest/gtest.h"
 #include "storage/b_plus_tree_test_util.h"  // NOLINT
@@ -122,6 +135,56 @@ class GradingExecutorTest : public ::testing::Test {
     return allocated_output_schemas_.back().get();
   }
 
+  /**
+   * Plans for comparing batch and tuple-at-a-time execution: a filtered scan of test_1,
+   * a group by over it, a scan of test_2 and a hash join of the two scans, in that order.
+   */
+  std::vector<std::unique_ptr<AbstractPlanNode>> MakeBatchTestPlans() {
+    std::vector<std::unique_ptr<AbstractPlanNode>> plans;
+    // SELECT colA, colB, colC FROM test_1 WHERE colA < 600
+    auto table1 = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto colA = MakeColumnValueExpression(table1->schema_, 0, "colA");
+    auto const600 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(600));
+    const Schema *scan_schema = MakeOutputSchema({{"colA", colA},
+                                                  {"colB", MakeColumnValueExpression(table1->schema_, 0, "colB")},
+                                                  {"colC", MakeColumnValueExpression(table1->schema_, 0, "colC")}});
+    plans.emplace_back(std::make_unique<SeqScanPlanNode>(
+        scan_schema, MakeComparisonExpression(colA, const600, ComparisonType::LessThan), table1->oid_));
+    const AbstractPlanNode *scan_plan = plans.back().get();
+
+    // SELECT colB, count(colA), sum(colC) ... GROUP BY colB HAVING count(colA) > 50
+    auto scan_colA = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    auto scan_colB = MakeColumnValueExpression(*scan_schema, 0, "colB");
+    auto scan_colC = MakeColumnValueExpression(*scan_schema, 0, "colC");
+    auto countA = MakeAggregateValueExpression(false, 0);
+    auto having = MakeComparisonExpression(countA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(50)),
+                                           ComparisonType::GreaterThan);
+    auto groupbyB = MakeAggregateValueExpression(true, 0);
+    auto sumC = MakeAggregateValueExpression(false, 1);
+    const Schema *agg_schema = MakeOutputSchema({{"colB", groupbyB}, {"countA", countA}, {"sumC", sumC}});
+    plans.emplace_back(std::make_unique<AggregationPlanNode>(
+        agg_schema, scan_plan, having, std::vector<const AbstractExpression *>{scan_colB},
+        std::vector<const AbstractExpression *>{scan_colA, scan_colC},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate}));
+
+    // SELECT col1, col2 FROM test_2
+    auto table2 = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    const Schema *scan2_schema = MakeOutputSchema({{"col1", MakeColumnValueExpression(table2->schema_, 0, "col1")},
+                                                   {"col2", MakeColumnValueExpression(table2->schema_, 0, "col2")}});
+    plans.emplace_back(std::make_unique<SeqScanPlanNode>(scan2_schema, nullptr, table2->oid_));
+    const AbstractPlanNode *scan2_plan = plans.back().get();
+
+    // ... JOIN test_2 ON colB = col2 AND colA > col1
+    auto col1 = MakeColumnValueExpression(*scan2_schema, 1, "col1");
+    auto col2 = MakeColumnValueExpression(*scan2_schema, 1, "col2");
+    const Schema *join_schema = MakeOutputSchema({{"colA", scan_colA}, {"colC", scan_colC}, {"col1", col1}});
+    plans.emplace_back(std::make_unique<HashJoinPlanNode>(
+        join_schema, std::vector<const AbstractPlanNode *>{scan_plan, scan2_plan},
+        std::vector<const AbstractExpression *>{scan_colB}, std::vector<const AbstractExpression *>{col2},
+        MakeComparisonExpression(scan_colA, col1, ComparisonType::GreaterThan)));
+    return plans;
+  }
+
  private:
   std::unique_ptr<TransactionManager> txn_mgr_;
   Transaction *txn_{nullptr};
@@ -198,6 +261,271 @@ TEST_F(GradingExecutorTest, SimpleIndexScanTest) {
   delete key_schema;
 }
 
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, IndexScanKeyRangeTest) {
+  // SELECT colA, colB FROM test_1 WHERE colA <= 100 / WHERE 500 = colA
+
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  auto index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index1", "test_1", table_info->schema_, *key_schema, {0}, 8);
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  {
+    auto *const100 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(100));
+    auto *predicate = MakeComparisonExpression(colA, const100, ComparisonType::LessThanOrEqual);
+    IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+    ASSERT_TRUE(plan.HasKeyRange());
+    ASSERT_FALSE(plan.HasLowKey());
+    ASSERT_TRUE(plan.HasHighKey());
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 101);
+    for (size_t i = 0; i < result_set.size(); ++i) {
+      ASSERT_EQ(result_set[i].GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>(), i);
+    }
+  }
+  {
+    auto *const500 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(500));
+    auto *predicate = MakeComparisonExpression(const500, colA, ComparisonType::Equal);
+    IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+    ASSERT_TRUE(plan.HasLowKey());
+    ASSERT_TRUE(plan.HasHighKey());
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 1);
+    ASSERT_EQ(result_set[0].GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>(), 500);
+  }
+
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, IndexScanCoveringTest) {
+  // SELECT colA FROM test_1 WHERE colA >= 900
+
+  TableMetadata *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  Schema &schema = table_info->schema_;
+
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  auto index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index1", "test_1", table_info->schema_, *key_schema, {0}, 8);
+
+  // drop the heap tuples behind the index's back, an index-only scan must not notice
+  for (auto iter = table_info->table_->Begin(GetTxn()); iter != table_info->table_->End(); ++iter) {
+    if (iter->GetValue(&schema, 0).GetAs<int32_t>() >= 900) {
+      table_info->table_->ApplyDelete(iter->GetRid(), GetTxn());
+    }
+  }
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  auto *const900 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(900));
+  auto *predicate = MakeComparisonExpression(colA, const900, ComparisonType::GreaterThanOrEqual);
+  IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), TEST1_SIZE - 900);
+  for (size_t i = 0; i < result_set.size(); ++i) {
+    ASSERT_EQ(result_set[i].GetValue(out_schema, 0).GetAs<int32_t>(), 900 + i);
+  }
+
+  // with logging on the scan reads the heap, which takes the tuple locks, and sees the deletes
+  enable_logging = true;
+  result_set.clear();
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+  enable_logging = false;
+  ASSERT_TRUE(result_set.empty());
+  GetTxn()->SetState(TransactionState::GROWING);
+
+  // colB is not in the index, those tuples come from the heap
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const10 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(10));
+  auto *out_schema_b = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  IndexScanPlanNode plan_b{out_schema_b, MakeComparisonExpression(colA, const10, ComparisonType::LessThan),
+                           index_info->index_oid_};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&plan_b, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 10);
+  for (size_t i = 0; i < result_set.size(); ++i) {
+    ASSERT_EQ(result_set[i].GetValue(out_schema_b, 0).GetAs<int32_t>(), i);
+    ASSERT_LT(result_set[i].GetValue(out_schema_b, 1).GetAs<int32_t>(), 10);
+  }
+
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, VarcharIndexScanTest) {
+  // SELECT colA, colB FROM varchar_table WHERE colB >= 'name_...00300', with an index on colB
+  Schema table_schema({Column("colA", TypeId::INTEGER), Column("colB", TypeId::VARCHAR, 128)});
+  auto table_info = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "varchar_table", table_schema);
+  auto &schema = table_info->schema_;
+  const int32_t num_rows = 500;
+  // long common prefix, keys would not fit a GenericKey<64>
+  auto name = [](int32_t i) {
+    std::string digits = std::to_string(i);
+    return "name_" + std::string(80, 'x') + std::string(5 - digits.size(), '0') + digits;
+  };
+  auto insert_rows = [&](int32_t begin, int32_t end) {
+    std::vector<std::vector<Value>> raw_vals;
+    for (int32_t i = begin; i < end; ++i) {
+      int32_t key = i * 7 % num_rows;
+      raw_vals.push_back({ValueFactory::GetIntegerValue(key), ValueFactory::GetVarcharValue(name(key))});
+    }
+    InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+    GetExecutionEngine()->Execute(&insert_plan, nullptr, GetTxn(), GetExecutorContext());
+  };
+
+  // half of the rows are loaded by CreateIndex, the other half maintained by the insert executor
+  insert_rows(0, num_rows / 2);
+  Schema *key_schema = ParseCreateStatement("b varchar(128)");
+  auto index_info = GetExecutorContext()->GetCatalog()->CreateIndex<GenericKey<64>, RID, GenericComparator<64>>(
+      GetTxn(), "index1", "varchar_table", schema, *key_schema, {1}, 64);
+  ASSERT_NE(nullptr, dynamic_cast<VarlenBPlusTreeIndex *>(index_info->index_.get()));
+  insert_rows(num_rows / 2, num_rows);
+
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *colB = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const300 = MakeConstantValueExpression(ValueFactory::GetVarcharValue(name(300)));
+  auto *predicate = MakeComparisonExpression(colB, const300, ComparisonType::GreaterThanOrEqual);
+  auto *out_schema = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+  IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), num_rows - 300);
+  for (size_t i = 0; i < result_set.size(); ++i) {
+    ASSERT_EQ(result_set[i].GetValue(out_schema, 0).GetAs<int32_t>(), 300 + i);
+    ASSERT_EQ(result_set[i].GetValue(out_schema, 1).ToString(), name(300 + i));
+  }
+
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, OnlineCreateIndexTest) {
+  // INSERT INTO test_1 VALUES (1000 + i, ...) and DELETE FROM test_1 WHERE colA = i, while an index on colA is built
+  const int32_t num_ops = 200;
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *colA = MakeColumnValueExpression(schema, 0, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", colA}});
+  std::vector<std::unique_ptr<AbstractPlanNode>> plans;
+  for (int32_t i = 0; i < num_ops; ++i) {
+    std::vector<Value> values;
+    for (int32_t col = 0; col < 4; ++col) {
+      values.push_back(ValueFactory::GetIntegerValue(col == 0 ? static_cast<int32_t>(TEST1_SIZE) + i : 0));
+    }
+    std::vector<std::vector<Value>> raw_vals{values};
+    plans.push_back(std::make_unique<InsertPlanNode>(std::move(raw_vals), table_info->oid_));
+    auto *predicate = MakeComparisonExpression(colA, MakeConstantValueExpression(ValueFactory::GetIntegerValue(i)),
+                                               ComparisonType::Equal);
+    plans.push_back(std::make_unique<SeqScanPlanNode>(out_schema, predicate, table_info->oid_));
+    plans.push_back(std::make_unique<DeletePlanNode>(plans.back().get(), table_info->oid_));
+  }
+
+  // the index is registered while the writer runs, possibly in the middle of a statement
+  std::atomic<int32_t> done{0};
+  std::thread writer([&] {
+    for (int32_t i = 0; i < num_ops; ++i) {
+      auto txn = GetTxnManager()->Begin();
+      auto exec_ctx = std::make_unique<ExecutorContext>(txn, GetCatalog(), GetBPM());
+      GetExecutionEngine()->Execute(plans[3 * i].get(), nullptr, txn, exec_ctx.get());
+      GetExecutionEngine()->Execute(plans[3 * i + 2].get(), nullptr, txn, exec_ctx.get());
+      GetTxnManager()->Commit(txn);
+      delete txn;
+      done++;
+    }
+  });
+  while (done < num_ops / 4) {
+    std::this_thread::yield();
+  }
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  IndexInfo *index_info = GetCatalog()->CreateIndexOnline<GenericKey<8>, RID, GenericComparator<8>>(
+      "index1", "test_1", schema, *key_schema, {0}, 8);
+  writer.join();
+  index_info->WaitUntilReady();
+  ASSERT_TRUE(index_info->IsReady());
+
+  // the index holds exactly the live tuples
+  size_t count = 0;
+  std::vector<RID> rids;
+  for (auto iter = table_info->table_->Begin(GetTxn()); iter != table_info->table_->End(); ++iter) {
+    count++;
+    rids.clear();
+    index_info->index_->ScanKey(iter->KeyFromTuple(schema, *key_schema, {0}), &rids, GetTxn());
+    ASSERT_EQ(1, rids.size());
+    ASSERT_EQ(iter->GetRid(), rids[0]);
+  }
+  ASSERT_EQ(TEST1_SIZE, count);
+  std::vector<Tuple> result_set;
+  auto *const0 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(0));
+  IndexScanPlanNode index_plan{out_schema, MakeComparisonExpression(colA, const0, ComparisonType::GreaterThanOrEqual),
+                               index_info->index_oid_};
+  result_set.clear();
+  GetExecutionEngine()->Execute(&index_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(TEST1_SIZE, result_set.size());
+  for (size_t i = 0; i < result_set.size(); ++i) {
+    ASSERT_EQ(num_ops + i, result_set[i].GetValue(out_schema, 0).GetAs<int32_t>());
+  }
+
+  // statements against a building index only reach the side log until the build finishes
+  index_info->state_ = IndexState::BUILDING;
+  std::vector<Value> values{ValueFactory::GetIntegerValue(-1), ValueFactory::GetIntegerValue(0),
+                            ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(0)};
+  std::vector<std::vector<Value>> raw_vals{values};
+  InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+  GetExecutionEngine()->Execute(&insert_plan, nullptr, GetTxn(), GetExecutorContext());
+  auto *const_num_ops = MakeConstantValueExpression(ValueFactory::GetIntegerValue(num_ops));
+  SeqScanPlanNode delete_scan{out_schema, MakeComparisonExpression(colA, const_num_ops, ComparisonType::Equal),
+                              table_info->oid_};
+  DeletePlanNode delete_plan{&delete_scan, table_info->oid_};
+  GetExecutionEngine()->Execute(&delete_plan, nullptr, GetTxn(), GetExecutorContext());
+  Tuple inserted{values, &schema};
+  values[0] = ValueFactory::GetIntegerValue(num_ops);
+  Tuple deleted{values, &schema};
+  auto scan_key = [&](const Tuple &tuple) {
+    rids.clear();
+    index_info->index_->ScanKey(tuple.KeyFromTuple(schema, *key_schema, {0}), &rids, GetTxn());
+    return rids.size();
+  };
+  ASSERT_EQ(0, scan_key(inserted));
+  ASSERT_EQ(1, scan_key(deleted));
+  index_info->FinishBuild(GetTxn());
+  ASSERT_TRUE(index_info->IsReady());
+  ASSERT_EQ(1, scan_key(inserted));
+  ASSERT_EQ(0, scan_key(deleted));
+
+  // an insert initialized before the index is created still maintains it
+  values[0] = ValueFactory::GetIntegerValue(-2);
+  std::vector<std::vector<Value>> in_flight_vals{values};
+  InsertPlanNode in_flight_plan{std::move(in_flight_vals), table_info->oid_};
+  auto in_flight = ExecutorFactory::CreateExecutor(GetExecutorContext(), &in_flight_plan);
+  in_flight->Init();
+  IndexInfo *index2_info = GetCatalog()->CreateIndexOnline<GenericKey<8>, RID, GenericComparator<8>>(
+      "index2", "test_1", schema, *key_schema, {0}, 8);
+  // the build has scanned the table by now, only the insert itself can add the key
+  index2_info->WaitUntilReady();
+  Tuple tuple;
+  RID rid;
+  in_flight->Next(&tuple, &rid);
+  rids.clear();
+  index2_info->index_->ScanKey(Tuple{values, &schema}.KeyFromTuple(schema, *key_schema, {0}), &rids, GetTxn());
+  ASSERT_EQ(1, rids.size());
+
+  delete key_schema;
+}
+
 // NOLINTNEXTLINE
 TEST_F(GradingExecutorTest, SimpleRawInsertWithIndexTest) {
   // INSERT INTO empty_table2 VALUES (200, 20), (201, 21), (202, 22)
@@ -522,6 +850,552 @@ TEST_F(GradingExecutorTest, SimpleNestedLoopJoinTest) {
   }
 }
 
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, SimpleHashJoinTest) {
+  // SELECT test_1.colA, test_1.colB, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.colA = test_2.col1 AND
+  // test_1.colB < 5, once with test_1 and once with test_2 as the left child
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col3 = MakeColumnValueExpression(schema, 0, "col3");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col3", col3}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+
+  for (bool test_1_left : {true, false}) {
+    uint32_t idx1 = test_1_left ? 0 : 1;
+    uint32_t idx2 = 1 - idx1;
+    auto colA = MakeColumnValueExpression(*out_schema1, idx1, "colA");
+    auto colB = MakeColumnValueExpression(*out_schema1, idx1, "colB");
+    auto col1 = MakeColumnValueExpression(*out_schema2, idx2, "col1");
+    auto col3 = MakeColumnValueExpression(*out_schema2, idx2, "col3");
+    auto const5 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(5));
+    auto predicate = MakeComparisonExpression(colB, const5, ComparisonType::LessThan);
+    const Schema *out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}, {"col3", col3}});
+    std::vector<const AbstractPlanNode *> children{scan_plan1.get(), scan_plan2.get()};
+    std::vector<const AbstractExpression *> left_keys{colA};
+    std::vector<const AbstractExpression *> right_keys{col1};
+    if (!test_1_left) {
+      std::swap(children[0], children[1]);
+      std::swap(left_keys, right_keys);
+    }
+    HashJoinPlanNode join_plan(out_final, std::move(children), std::move(left_keys), std::move(right_keys), predicate);
+
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+
+    // test_2.col1 is 0..99, every col1 meets exactly one colA
+    std::unordered_set<int32_t> seen;
+    for (const auto &tuple : result_set) {
+      auto col_a_val = tuple.GetValue(out_final, out_final->GetColIdx("colA")).GetAs<int32_t>();
+      auto col_1_val = tuple.GetValue(out_final, out_final->GetColIdx("col1")).GetAs<int16_t>();
+      ASSERT_EQ(col_a_val, col_1_val);
+      ASSERT_LT(tuple.GetValue(out_final, out_final->GetColIdx("colB")).GetAs<int32_t>(), 5);
+      ASSERT_TRUE(seen.insert(col_a_val).second);
+    }
+    ASSERT_GT(result_set.size(), 0);
+    ASSERT_LT(result_set.size(), TEST2_SIZE);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, HashJoinDuplicateKeysTest) {
+  // SELECT test_1.colA, test_2.col1 FROM test_1 JOIN test_2 ON test_1.colB = test_2.col2
+  // colB and col2 take 10 values each, and col2 can be NULL; the hash join must match the nested loop join, in
+  // memory or spilled
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  const Schema *out_schema1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto colA = MakeColumnValueExpression(schema, 0, "colA");
+    auto colB = MakeColumnValueExpression(schema, 0, "colB");
+    out_schema1 = MakeOutputSchema({{"colA", colA}, {"colB", colB}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  const Schema *out_schema2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto col2 = MakeColumnValueExpression(schema, 0, "col2");
+    out_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+  auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+  auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+  auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+  auto col2 = MakeColumnValueExpression(*out_schema2, 1, "col2");
+  const Schema *out_final = MakeOutputSchema({{"colA", colA}, {"col1", col1}});
+
+  auto collect = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::pair<int32_t, int16_t>> pairs;
+    for (const auto &tuple : result_set) {
+      pairs.emplace_back(tuple.GetValue(out_final, 0).GetAs<int32_t>(), tuple.GetValue(out_final, 1).GetAs<int16_t>());
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  };
+
+  NestedLoopJoinPlanNode nlj_plan(out_final, {scan_plan1.get(), scan_plan2.get()},
+                                  MakeComparisonExpression(colB, col2, ComparisonType::Equal));
+  HashJoinPlanNode hash_join_plan(out_final, {scan_plan1.get(), scan_plan2.get()}, {colB}, {col2});
+  auto expected = collect(&nlj_plan);
+  ASSERT_GT(expected.size(), TEST1_SIZE);
+  ASSERT_EQ(expected, collect(&hash_join_plan));
+
+  // the same join through TmpTuplePage partitions; with 256 bytes even a single colB value is over the budget
+  for (size_t budget : {4096, 256}) {
+    GetExecutorContext()->SetMemoryBudget(budget);
+    ASSERT_EQ(expected, collect(&hash_join_plan)) << "budget " << budget;
+  }
+  GetExecutorContext()->SetMemoryBudget(0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, SimpleMergeJoinTest) {
+  // SELECT test_1.colA, test_1.colB, test_3.col1 FROM test_1 JOIN test_3 ON test_1.colA = test_3.col1, both sides
+  // read in key order through an index
+  Catalog *catalog = GetExecutorContext()->GetCatalog();
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  TableMetadata *table1 = catalog->GetTable("test_1");
+  TableMetadata *table3 = catalog->GetTable("test_3");
+  auto index1 = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index1", "test_1", table1->schema_, *key_schema, {0}, 8);
+  auto index3 = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index3", "test_3", table3->schema_, *key_schema, {0}, 8);
+
+  const Schema *out_schema1 = MakeOutputSchema({{"colA", MakeColumnValueExpression(table1->schema_, 0, "colA")},
+                                                {"colB", MakeColumnValueExpression(table1->schema_, 0, "colB")}});
+  IndexScanPlanNode scan_plan1(out_schema1, nullptr, index1->index_oid_);
+  const Schema *out_schema3 = MakeOutputSchema({{"col1", MakeColumnValueExpression(table3->schema_, 0, "col1")}});
+  IndexScanPlanNode scan_plan3(out_schema3, nullptr, index3->index_oid_);
+
+  auto colA = MakeColumnValueExpression(*out_schema1, 0, "colA");
+  auto colB = MakeColumnValueExpression(*out_schema1, 0, "colB");
+  auto col1 = MakeColumnValueExpression(*out_schema3, 1, "col1");
+  ASSERT_TRUE(MergeJoinPlanNode::IsOrderedOn(catalog, &scan_plan1, {colA}));
+  ASSERT_TRUE(MergeJoinPlanNode::IsOrderedOn(catalog, &scan_plan3, {col1}));
+  ASSERT_FALSE(MergeJoinPlanNode::IsOrderedOn(catalog, &scan_plan1, {colB}));
+  SeqScanPlanNode seq_scan_plan(out_schema1, nullptr, table1->oid_);
+  ASSERT_FALSE(MergeJoinPlanNode::IsOrderedOn(catalog, &seq_scan_plan, {colA}));
+
+  const Schema *out_final = MakeOutputSchema({{"colA", colA}, {"colB", colB}, {"col1", col1}});
+  MergeJoinPlanNode join_plan(out_final, {&scan_plan1, &scan_plan3}, {colA}, {col1});
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+
+  // results come out in key order
+  ASSERT_EQ(result_set.size(), TEST2_SIZE);
+  for (size_t i = 0; i < result_set.size(); i++) {
+    ASSERT_EQ(result_set[i].GetValue(out_final, 0).GetAs<int32_t>(), i);
+    ASSERT_EQ(result_set[i].GetValue(out_final, 2).GetAs<int32_t>(), i);
+  }
+
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, MergeJoinDuplicateKeysTest) {
+  // SELECT l.colA, r.colA FROM test_1 l JOIN test_1 r ON l.colB = r.colB AND r.colA < 100
+  // every colB value is repeated on both sides; the merge join must match the hash join. The tree holds unique
+  // keys, so the index is on (colB, colA), which still orders the scans on colB
+  Catalog *catalog = GetExecutorContext()->GetCatalog();
+  Schema *key_schema = ParseCreateStatement("b int,a int");
+  TableMetadata *table1 = catalog->GetTable("test_1");
+  auto index = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      GetTxn(), "index_ba", "test_1", table1->schema_, *key_schema, {1, 0}, 8);
+
+  auto table_colA = MakeColumnValueExpression(table1->schema_, 0, "colA");
+  const Schema *out_schema = MakeOutputSchema(
+      {{"colA", table_colA}, {"colB", MakeColumnValueExpression(table1->schema_, 0, "colB")}});
+  IndexScanPlanNode left_plan(out_schema, nullptr, index->index_oid_);
+  auto *const100 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(100));
+  IndexScanPlanNode right_plan(out_schema, MakeComparisonExpression(table_colA, const100, ComparisonType::LessThan),
+                               index->index_oid_);
+
+  auto left_colA = MakeColumnValueExpression(*out_schema, 0, "colA");
+  auto left_colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+  auto right_colA = MakeColumnValueExpression(*out_schema, 1, "colA");
+  auto right_colB = MakeColumnValueExpression(*out_schema, 1, "colB");
+  ASSERT_TRUE(MergeJoinPlanNode::IsOrderedOn(catalog, &left_plan, {left_colB}));
+  const Schema *out_final = MakeOutputSchema({{"l", left_colA}, {"r", right_colA}});
+
+  auto collect = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    for (const auto &tuple : result_set) {
+      pairs.emplace_back(tuple.GetValue(out_final, 0).GetAs<int32_t>(), tuple.GetValue(out_final, 1).GetAs<int32_t>());
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  };
+
+  MergeJoinPlanNode merge_join_plan(out_final, {&left_plan, &right_plan}, {left_colB}, {right_colB});
+  HashJoinPlanNode hash_join_plan(out_final, {&left_plan, &right_plan}, {left_colB}, {right_colB});
+  auto expected = collect(&hash_join_plan);
+  ASSERT_GT(expected.size(), TEST1_SIZE);
+  ASSERT_EQ(expected, collect(&merge_join_plan));
+
+  delete key_schema;
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, SimpleSortTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB ASC, colA DESC, and ORDER BY colB alone, which keeps the scan order
+  // of each colB. With 2048 bytes of memory the sort writes dozens of runs and merges them in more than one pass
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  const Schema *out_schema = MakeOutputSchema(
+      {{"colA", MakeColumnValueExpression(schema, 0, "colA")}, {"colB", MakeColumnValueExpression(schema, 0, "colB")}});
+  SeqScanPlanNode scan_plan(out_schema, nullptr, table_info->oid_);
+  auto colA = MakeColumnValueExpression(*out_schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+
+  SortPlanNode sort_plan(out_schema, &scan_plan, {{OrderByType::ASC, colB}, {OrderByType::DESC, colA}});
+  SortPlanNode stable_plan(out_schema, &scan_plan, {{OrderByType::ASC, colB}});
+  for (size_t budget : {0, 2048}) {
+    GetExecutorContext()->SetMemoryBudget(budget);
+    for (bool stable : {false, true}) {
+      std::vector<Tuple> result_set;
+      GetExecutionEngine()->Execute(stable ? &stable_plan : &sort_plan, &result_set, GetTxn(), GetExecutorContext());
+      ASSERT_EQ(result_set.size(), TEST1_SIZE);
+      for (size_t i = 1; i < result_set.size(); i++) {
+        int32_t prev_a = result_set[i - 1].GetValue(out_schema, 0).GetAs<int32_t>();
+        int32_t prev_b = result_set[i - 1].GetValue(out_schema, 1).GetAs<int32_t>();
+        int32_t a = result_set[i].GetValue(out_schema, 0).GetAs<int32_t>();
+        int32_t b = result_set[i].GetValue(out_schema, 1).GetAs<int32_t>();
+        ASSERT_LE(prev_b, b) << "budget " << budget;
+        if (prev_b == b) {
+          ASSERT_TRUE(stable ? prev_a < a : prev_a > a) << "budget " << budget;
+        }
+      }
+    }
+
+    // every tuple comes out with the rid the scan gave it, also after it went through a run
+    std::unordered_map<int32_t, RID> scan_rids;
+    auto scan = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+    scan->Init();
+    Tuple tuple;
+    RID rid;
+    while (scan->Next(&tuple, &rid)) {
+      scan_rids[tuple.GetValue(out_schema, 0).GetAs<int32_t>()] = rid;
+    }
+    ASSERT_EQ(scan_rids.size(), TEST1_SIZE);
+    auto sort = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    sort->Init();
+    size_t num_tuples = 0;
+    while (sort->Next(&tuple, &rid)) {
+      ASSERT_EQ(rid, scan_rids[tuple.GetValue(out_schema, 0).GetAs<int32_t>()]) << "budget " << budget;
+      num_tuples++;
+    }
+    ASSERT_EQ(num_tuples, TEST1_SIZE);
+  }
+  GetExecutorContext()->SetMemoryBudget(0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, SortNullsTest) {
+  // SELECT col1, col2 FROM test_2 ORDER BY col2 ASC / DESC: NULL comes first in ASC and last in DESC
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+  auto &schema = table_info->schema_;
+  const Schema *out_schema = MakeOutputSchema(
+      {{"col1", MakeColumnValueExpression(schema, 0, "col1")}, {"col2", MakeColumnValueExpression(schema, 0, "col2")}});
+  SeqScanPlanNode scan_plan(out_schema, nullptr, table_info->oid_);
+  auto col2 = MakeColumnValueExpression(*out_schema, 0, "col2");
+
+  for (OrderByType order_by_type : {OrderByType::ASC, OrderByType::DESC}) {
+    SortPlanNode sort_plan(out_schema, &scan_plan, {{order_by_type, col2}});
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(&sort_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), TEST2_SIZE);
+    if (order_by_type == OrderByType::DESC) {
+      std::reverse(result_set.begin(), result_set.end());
+    }
+    bool seen_value = false;
+    for (size_t i = 0; i < result_set.size(); i++) {
+      Value value = result_set[i].GetValue(out_schema, 1);
+      if (value.IsNull()) {
+        ASSERT_FALSE(seen_value);
+        continue;
+      }
+      if (seen_value) {
+        ASSERT_EQ(CmpBool::CmpTrue, result_set[i - 1].GetValue(out_schema, 1).CompareLessThanEquals(value));
+      }
+      seen_value = true;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, TopNTest) {
+  // SELECT colA, colB FROM test_1 ORDER BY colB DESC, colA LIMIT limit OFFSET offset, run through the fused top-n
+  // executor and compared with the full sort
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  const Schema *out_schema = MakeOutputSchema(
+      {{"colA", MakeColumnValueExpression(schema, 0, "colA")}, {"colB", MakeColumnValueExpression(schema, 0, "colB")}});
+  SeqScanPlanNode scan_plan(out_schema, nullptr, table_info->oid_);
+  auto colA = MakeColumnValueExpression(*out_schema, 0, "colA");
+  auto colB = MakeColumnValueExpression(*out_schema, 0, "colB");
+  SortPlanNode sort_plan(out_schema, &scan_plan, {{OrderByType::DESC, colB}, {OrderByType::ASC, colA}});
+
+  std::vector<Tuple> sorted;
+  GetExecutionEngine()->Execute(&sort_plan, &sorted, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(sorted.size(), TEST1_SIZE);
+  // the rids of the full sort, which are the rids of the scan
+  std::vector<RID> sorted_rids;
+  auto sort = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+  sort->Init();
+  Tuple tuple;
+  RID rid;
+  while (sort->Next(&tuple, &rid)) {
+    ASSERT_NE(rid.GetPageId(), INVALID_PAGE_ID);
+    sorted_rids.push_back(rid);
+  }
+  ASSERT_EQ(sorted_rids.size(), TEST1_SIZE);
+
+  // offset + limit may overflow, and a small memory budget falls back to the spilling sort
+  size_t max_limit = std::numeric_limits<size_t>::max();
+  std::vector<std::pair<size_t, size_t>> limit_offsets{{10, 0}, {10, 5}, {100, 950}, {0, 3}, {2000, 0}, {5, 1000}};
+  limit_offsets.insert(limit_offsets.end(), {{10, 995}, {max_limit, 0}, {max_limit, 2}, {max_limit - 1, 5}});
+  for (size_t budget : {0, 4096}) {
+    GetExecutorContext()->SetMemoryBudget(budget);
+    for (const auto &[limit, offset] : limit_offsets) {
+      LimitPlanNode limit_plan(out_schema, &sort_plan, limit, offset);
+      std::vector<Tuple> result_set;
+      GetExecutionEngine()->Execute(&limit_plan, &result_set, GetTxn(), GetExecutorContext());
+      size_t table_size = TEST1_SIZE;
+      size_t expected_size = std::min(limit, table_size - std::min(offset, table_size));
+      ASSERT_EQ(result_set.size(), expected_size) << "limit " << limit << " offset " << offset << " budget " << budget;
+      for (size_t i = 0; i < result_set.size(); i++) {
+        ASSERT_EQ(result_set[i].GetValue(out_schema, 0).GetAs<int32_t>(),
+                  sorted[offset + i].GetValue(out_schema, 0).GetAs<int32_t>());
+      }
+
+      // the fused top-n and the limit over the sort both output the child's rids
+      auto limit_executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &limit_plan);
+      limit_executor->Init();
+      for (size_t i = 0; limit_executor->Next(&tuple, &rid); i++) {
+        ASSERT_EQ(rid, sorted_rids[offset + i]) << "limit " << limit << " offset " << offset << " budget " << budget;
+      }
+    }
+  }
+  GetExecutorContext()->SetMemoryBudget(0);
+
+  // a limit over an unsorted child still just skips and counts
+  LimitPlanNode scan_limit_plan(out_schema, &scan_plan, 3, 2);
+  std::vector<Tuple> result_set;
+  GetExecutionEngine()->Execute(&scan_limit_plan, &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), 3);
+  for (size_t i = 0; i < result_set.size(); i++) {
+    ASSERT_EQ(result_set[i].GetValue(out_schema, 0).GetAs<int32_t>(), i + 2);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, SortKeyTest) {
+  // normalized keys compare as bytes in the order of their values
+  auto key_of = [](const std::vector<Value> &values, OrderByType order_by_type) {
+    std::string key;
+    for (const auto &value : values) {
+      SortExecutor::AppendSortKey(value, order_by_type, &key);
+    }
+    return key;
+  };
+  std::vector<std::vector<Value>> ordered{
+      {ValueFactory::GetNullValueByType(TypeId::INTEGER)},
+      {ValueFactory::GetIntegerValue(-100000)},
+      {ValueFactory::GetIntegerValue(-1)},
+      {ValueFactory::GetSmallIntValue(0)},
+      {ValueFactory::GetBigIntValue(int64_t{1} << 40)},
+  };
+  std::vector<std::vector<Value>> decimals{
+      {ValueFactory::GetDecimalValue(-2.5)},
+      {ValueFactory::GetDecimalValue(-0.5)},
+      {ValueFactory::GetDecimalValue(0)},
+      {ValueFactory::GetDecimalValue(0.25)},
+      {ValueFactory::GetDecimalValue(1e10)},
+  };
+  // a prefix sorts first, and a shorter first term wins over a larger second term
+  std::vector<std::vector<Value>> varchars{
+      {ValueFactory::GetVarcharValue(""), ValueFactory::GetIntegerValue(9)},
+      {ValueFactory::GetVarcharValue("ab"), ValueFactory::GetIntegerValue(9)},
+      {ValueFactory::GetVarcharValue("abc"), ValueFactory::GetIntegerValue(1)},
+      {ValueFactory::GetVarcharValue("abd"), ValueFactory::GetIntegerValue(0)},
+  };
+  for (const auto &values : {ordered, decimals, varchars}) {
+    for (size_t i = 1; i < values.size(); i++) {
+      EXPECT_LT(key_of(values[i - 1], OrderByType::ASC), key_of(values[i], OrderByType::ASC)) << i;
+      EXPECT_GT(key_of(values[i - 1], OrderByType::DESC), key_of(values[i], OrderByType::DESC)) << i;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, BatchExecutionTest) {
+  // every plan yields the same rows through NextBatch as through Next, including executors that only have the
+  // Next adapter (limit, sort, and the hash join over them) and a hash join that spills
+  auto plans = MakeBatchTestPlans();
+  const AbstractPlanNode *scan_plan = plans[0].get();
+  const AbstractPlanNode *scan2_plan = plans[2].get();
+  const auto *join_plan = dynamic_cast<const HashJoinPlanNode *>(plans[3].get());
+  auto colB = MakeColumnValueExpression(*scan_plan->OutputSchema(), 0, "colB");
+  LimitPlanNode limit_plan(scan_plan->OutputSchema(), scan_plan, 700, 10);
+  SortPlanNode sort_plan(scan_plan->OutputSchema(), &limit_plan, {{OrderByType::DESC, colB}});
+  HashJoinPlanNode sorted_join_plan(join_plan->OutputSchema(), {&sort_plan, scan2_plan},
+                                    std::vector<const AbstractExpression *>(join_plan->GetLeftKeys()),
+                                    std::vector<const AbstractExpression *>(join_plan->GetRightKeys()));
+
+  auto collect = [&](const AbstractPlanNode *plan, bool batch) {
+    std::vector<Tuple> result_set;
+    if (batch) {
+      GetExecutionEngine()->ExecuteBatch(plan, &result_set, GetTxn(), GetExecutorContext());
+    } else {
+      GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    }
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      std::string row;
+      for (uint32_t i = 0; i < plan->OutputSchema()->GetColumnCount(); i++) {
+        row += tuple.GetValue(plan->OutputSchema(), i).ToString() + ",";
+      }
+      rows.push_back(row);
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  std::vector<const AbstractPlanNode *> roots{plans[0].get(), plans[1].get(), join_plan, &limit_plan, &sort_plan,
+                                              &sorted_join_plan};
+  for (size_t i = 0; i < roots.size(); i++) {
+    auto expected = collect(roots[i], false);
+    ASSERT_FALSE(expected.empty()) << "plan " << i;
+    ASSERT_EQ(expected, collect(roots[i], true)) << "plan " << i;
+  }
+  ASSERT_EQ(600, collect(scan_plan, true).size());
+
+  GetExecutorContext()->SetMemoryBudget(4096);
+  ASSERT_EQ(collect(join_plan, false), collect(join_plan, true));
+  GetExecutorContext()->SetMemoryBudget(0);
+}
+
+/*
+ * Microbenchmark: the batch test plans run tuple at a time and a batch at a time, with
+ * the result rows dropped.
+ */
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, DISABLED_BatchBenchmark) {
+  const int rounds = 200;
+  auto plans = MakeBatchTestPlans();
+  const char *names[] = {"scan + filter", "group by", "scan", "hash join"};
+  for (size_t i = 0; i < plans.size(); i++) {
+    // warm up the buffer pool
+    GetExecutionEngine()->Execute(plans[i].get(), nullptr, GetTxn(), GetExecutorContext());
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+      GetExecutionEngine()->Execute(plans[i].get(), nullptr, GetTxn(), GetExecutorContext());
+    }
+    auto mid = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+      GetExecutionEngine()->ExecuteBatch(plans[i].get(), nullptr, GetTxn(), GetExecutorContext());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto tuple_us = std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count();
+    auto batch_us = std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count();
+    printf("%s: Next %.1f us/query, NextBatch %.1f us/query\n", names[i], static_cast<double>(tuple_us) / rounds,
+           static_cast<double>(batch_us) / rounds);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(GradingExecutorTest, ParallelExecutionTest) {
+  // every plan yields the same rows on 4 threads as on one, in the same order for scans and sorts
+  auto plans = MakeBatchTestPlans();
+  const AbstractPlanNode *scan_plan = plans[0].get();
+  const AbstractPlanNode *join_plan = plans[3].get();
+  auto colB = MakeColumnValueExpression(*scan_plan->OutputSchema(), 0, "colB");
+  auto join_colA = MakeColumnValueExpression(*join_plan->OutputSchema(), 0, "colA");
+  auto join_col1 = MakeColumnValueExpression(*join_plan->OutputSchema(), 0, "col1");
+  // 排序键有重复, 相同键按扫描顺序输出
+  SortPlanNode sort_plan(scan_plan->OutputSchema(), scan_plan, {{OrderByType::ASC, colB}});
+  SortPlanNode sorted_join_plan(join_plan->OutputSchema(), join_plan,
+                                {{OrderByType::DESC, join_colA}, {OrderByType::ASC, join_col1}});
+  LimitPlanNode limit_plan(scan_plan->OutputSchema(), scan_plan, 10, 0);
+  ASSERT_TRUE(MorselScheduler::CanParallelize(&sorted_join_plan));
+  ASSERT_FALSE(MorselScheduler::CanParallelize(&limit_plan));
+
+  auto collect = [&](const AbstractPlanNode *plan, size_t parallelism, bool sorted) {
+    GetExecutorContext()->SetParallelism(parallelism);
+    std::vector<Tuple> result_set;
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      std::string row;
+      for (uint32_t i = 0; i < plan->OutputSchema()->GetColumnCount(); i++) {
+        row += tuple.GetValue(plan->OutputSchema(), i).ToString() + ",";
+      }
+      rows.push_back(row);
+    }
+    if (sorted) {
+      std::sort(rows.begin(), rows.end());
+    }
+    return rows;
+  };
+
+  std::vector<std::pair<const AbstractPlanNode *, bool>> roots{
+      {scan_plan, false}, {plans[1].get(), true}, {plans[2].get(), false},
+      {join_plan, true},  {&sort_plan, false},    {&sorted_join_plan, false}};
+  for (size_t i = 0; i < roots.size(); i++) {
+    auto expected = collect(roots[i].first, 1, roots[i].second);
+    ASSERT_FALSE(expected.empty()) << "plan " << i;
+    for (size_t parallelism : {2, 4}) {
+      ASSERT_EQ(expected, collect(roots[i].first, parallelism, roots[i].second)) << "plan " << i;
+    }
+  }
+  ASSERT_EQ(600, collect(scan_plan, 4, false).size());
+  ASSERT_EQ(collect(&limit_plan, 1, false), collect(&limit_plan, 4, false));
+
+  // test_1 fits in a few morsels, so also scan and sort a copy of it repeated 20 times
+  auto table1 = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto big_table = GetExecutorContext()->GetCatalog()->CreateTable(GetTxn(), "test_1_x20", table1->schema_);
+  for (int round = 0; round < 20; round++) {
+    for (auto iter = table1->table_->Begin(GetTxn()); iter != table1->table_->End(); ++iter) {
+      RID rid;
+      ASSERT_TRUE(big_table->table_->InsertTuple(*iter, &rid, GetTxn()));
+    }
+  }
+  ASSERT_GT(big_table->table_->GetPageIds().size(), 8 * MorselScheduler::MORSEL_PAGES);
+  SeqScanPlanNode big_scan_plan(scan_plan->OutputSchema(),
+                                dynamic_cast<const SeqScanPlanNode *>(scan_plan)->GetPredicate(), big_table->oid_);
+  SortPlanNode big_sort_plan(scan_plan->OutputSchema(), &big_scan_plan, {{OrderByType::ASC, colB}});
+  for (const AbstractPlanNode *plan : {static_cast<const AbstractPlanNode *>(&big_scan_plan),
+                                       static_cast<const AbstractPlanNode *>(&big_sort_plan)}) {
+    auto expected = collect(plan, 1, false);
+    ASSERT_EQ(20 * 600, expected.size());
+    ASSERT_EQ(expected, collect(plan, 4, false));
+  }
+  GetExecutorContext()->SetParallelism(1);
+}
+
 // NOLINTNEXTLINE
 TEST_F(GradingExecutorTest, SimpleAggregationTest) {
   // SELECT COUNT(colA), SUM(colA), min(colA), max(colA) from test_1;
@@ -843,7 +1717,9 @@ TEST_F(GradingExecutorTest, IntegratedTest) {
 //#include <vector>
 //
 //#include "execution/plans/delete_plan.h"
+#include "execution/plans/hash_join_plan.h"
 //#include "execution/plans/limit_plan.h"
+#include "execution/plans/merge_join_plan.h"
 //
 //#include "buffer/buffer_pool_manager.h"
 //#include "catalog/table_generator.h"
@@ -851,6 +1727,7 @@ TEST_F(GradingExecutorTest, IntegratedTest) {
 //#include "execution/execution_engine.h"
 //#include "execution/executor_context.h"
 //#include "execution/executors/aggregation_executor.h"
+#include "execution/executors/hash_join_executor.h"
 //#include "execution/executors/insert_executor.h"
 //#include "execution/executors/nested_loop_join_executor.h"
 //#include "execution/expressions/aggregate_value_expression.h"
@@ -2,6 +2,8 @@
  * b_plus_tree_test.cpp
  */
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>  // NOLINT
 #include <cstdio>
 #include <functional>
@@ -515,6 +517,324 @@ void MixTest3Call() {
   }
 }
 
+void AppendCall() {
+  for (size_t iter = 0; iter < NUM_ITERS / 10; iter++) {
+    // create KeyComparator and index schema
+    Schema *key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema);
+
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    // create b+ tree
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    // threads race on the rightmost leaf with interleaved serial keys
+    std::vector<int64_t> keys;
+    int64_t scale_factor = 1000;
+    for (int64_t key = 1; key <= scale_factor; key++) {
+      keys.push_back(key);
+    }
+    LaunchParallelTest(4, 1, InsertHelperSplit, &tree, keys, 4);
+
+    int64_t expected = 1;
+    for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+      EXPECT_EQ(expected, (*iterator).first.ToString());
+      expected++;
+    }
+    EXPECT_EQ(scale_factor + 1, expected);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete key_schema;
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+void ScanDuringChurnCall() {
+  for (size_t iter = 0; iter < NUM_ITERS / 10; iter++) {
+    // create KeyComparator and index schema
+    Schema *key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema);
+
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    // create b+ tree with small nodes so that the writers split and merge constantly
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    // odd keys stay in the tree, even keys come and go
+    std::vector<int64_t> stable_keys;
+    std::vector<int64_t> churn_keys;
+    size_t total_keys = 400;
+    for (size_t i = 1; i <= total_keys; i++) {
+      if (i % 2 == 1) {
+        stable_keys.push_back(i);
+      } else {
+        churn_keys.push_back(i);
+      }
+    }
+    InsertHelper(&tree, stable_keys, 1);
+
+    auto churn_task = [&](int tid) {
+      for (int round = 0; round < 3; round++) {
+        InsertHelper(&tree, churn_keys, tid);
+        DeleteHelper(&tree, churn_keys, tid);
+      }
+    };
+    // every scan must be strictly ordered and see all of the stable keys
+    auto scan_task = [&](int tid) {
+      for (int round = 0; round < 10; round++) {
+        bool reverse = (tid + round) % 2 == 0;
+        size_t stable_seen = 0;
+        int64_t prev = reverse ? INT64_MAX : INT64_MIN;
+        for (auto iterator = reverse ? tree.rbegin() : tree.begin(); iterator != tree.end(); ++iterator) {
+          int64_t key = (*iterator).first.ToString();
+          EXPECT_TRUE(reverse ? key < prev : key > prev);
+          prev = key;
+          stable_seen += key % 2;
+        }
+        EXPECT_EQ(stable_seen, stable_keys.size());
+      }
+    };
+    std::vector<std::function<void(int)>> tasks;
+    tasks.emplace_back(churn_task);
+    tasks.emplace_back(scan_task);
+    std::vector<std::thread> threads;
+    size_t num_threads = 6;
+    for (size_t i = 0; i < num_threads; i++) {
+      threads.emplace_back(std::thread{tasks[i % tasks.size()], i});
+    }
+    for (size_t i = 0; i < num_threads; i++) {
+      threads[i].join();
+    }
+
+    std::vector<int64_t> scanned;
+    for (auto iterator = tree.rbegin(); iterator != tree.end(); ++iterator) {
+      scanned.push_back((*iterator).first.ToString());
+    }
+    EXPECT_EQ(scanned, std::vector<int64_t>(stable_keys.rbegin(), stable_keys.rend()));
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete key_schema;
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+void LazyMergeCall() {
+  for (size_t iter = 0; iter < NUM_ITERS / 10; iter++) {
+    // create KeyComparator and index schema
+    Schema *key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema);
+
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+    tree.SetMergePolicy(MergePolicy::LAZY);
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    // odd keys stay in the tree, even keys come and go
+    std::vector<int64_t> stable_keys;
+    std::vector<int64_t> churn_keys;
+    for (int64_t i = 1; i <= 400; i++) {
+      (i % 2 == 1 ? stable_keys : churn_keys).push_back(i);
+    }
+    InsertHelper(&tree, stable_keys, 1);
+    InsertHelper(&tree, churn_keys, 1);
+
+    std::atomic<bool> churning{true};
+    // writers leave sparse leaves behind while compaction merges them
+    auto compact_task = [&](int tid) {
+      Transaction transaction(tid);
+      while (churning) {
+        tree.Compact(&transaction);
+      }
+      tree.Compact(&transaction);
+    };
+    std::thread compactor(compact_task, 0);
+    std::vector<std::thread> threads;
+    for (int tid = 1; tid <= 2; tid++) {
+      threads.emplace_back([&, tid] {
+        for (int round = 0; round < 3; round++) {
+          DeleteHelperSplit(&tree, churn_keys, 4, tid, (tid - 1) * 2);
+          InsertHelperSplit(&tree, churn_keys, 4, tid, (tid - 1) * 2);
+        }
+        DeleteHelperSplit(&tree, churn_keys, 4, tid, (tid - 1) * 2);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    churning = false;
+    compactor.join();
+
+    std::vector<int64_t> scanned;
+    for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+      scanned.push_back((*iterator).first.ToString());
+    }
+    EXPECT_EQ(scanned, stable_keys);
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete key_schema;
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+void LazyScanCall() {
+  for (size_t iter = 0; iter < NUM_ITERS / 10; iter++) {
+    // create KeyComparator and index schema
+    Schema *key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema);
+
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+    tree.SetMergePolicy(MergePolicy::LAZY);
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    // one key in 8 stays in the tree, so whole leaves of churn keys empty out under the scans
+    std::vector<int64_t> stable_keys;
+    std::vector<int64_t> churn_keys;
+    for (int64_t i = 1; i <= 400; i++) {
+      (i % 8 == 1 ? stable_keys : churn_keys).push_back(i);
+    }
+    InsertHelper(&tree, stable_keys, 1);
+
+    auto churn_task = [&](int tid) {
+      for (int round = 0; round < 3; round++) {
+        InsertHelper(&tree, churn_keys, tid);
+        DeleteHelper(&tree, churn_keys, tid);
+      }
+    };
+    // bounded scans in both directions must be strictly ordered and see the stable keys of their range
+    auto scan_task = [&](int tid) {
+      GenericKey<8> low_key;
+      GenericKey<8> high_key;
+      for (int round = 0; round < 20; round++) {
+        bool reverse = (tid + round) % 2 == 0;
+        int64_t low = 1 + (round * 37) % 200;
+        int64_t high = low + 150;
+        low_key.SetFromInteger(low);
+        high_key.SetFromInteger(high);
+        size_t stable_seen = 0;
+        int64_t prev = reverse ? INT64_MAX : INT64_MIN;
+        auto iterator = reverse ? tree.RBegin(&high_key, &low_key) : tree.Begin(&low_key, &high_key);
+        for (; iterator != tree.end(); ++iterator) {
+          int64_t key = (*iterator).first.ToString();
+          EXPECT_TRUE(reverse ? key < prev : key > prev);
+          EXPECT_TRUE(key >= low && key <= high);
+          prev = key;
+          stable_seen += key % 8 == 1 ? 1 : 0;
+        }
+        EXPECT_EQ(stable_seen, std::count_if(stable_keys.begin(), stable_keys.end(),
+                                             [&](int64_t key) { return key >= low && key <= high; }));
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < 6; tid++) {
+      threads.emplace_back(tid % 2 == 0 ? std::function<void(int)>(churn_task) : std::function<void(int)>(scan_task),
+                           tid);
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete key_schema;
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+void StatsDuringChurnCall() {
+  for (size_t iter = 0; iter < NUM_ITERS / 10; iter++) {
+    // create KeyComparator and index schema
+    Schema *key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema);
+
+    DiskManager *disk_manager = new DiskManager("test.db");
+    BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+
+    // create and fetch header_page
+    page_id_t page_id;
+    auto header_page = bpm->NewPage(&page_id);
+    (void)header_page;
+    // odd keys stay in the tree, even keys come and go
+    std::vector<int64_t> stable_keys;
+    std::vector<int64_t> churn_keys;
+    for (int64_t i = 1; i <= 400; i++) {
+      (i % 2 == 1 ? stable_keys : churn_keys).push_back(i);
+    }
+    InsertHelper(&tree, stable_keys, 1);
+
+    std::atomic<bool> churning{true};
+    // stats are only approximate while the writers split and merge, but stay within the tree's bounds
+    std::thread stats_thread([&] {
+      while (churning) {
+        for (double rate : {1.0, 0.25}) {
+          auto stats = tree.GetStats(rate);
+          ASSERT_LT(0, stats.height_);
+          ASSERT_EQ(stats.height_, stats.levels_.size());
+          EXPECT_LE(stats.num_keys_, 2 * (stable_keys.size() + churn_keys.size()));
+          for (const auto &level_stats : stats.levels_) {
+            EXPECT_LE(level_stats.num_sampled_, level_stats.num_pages_);
+            EXPECT_LE(level_stats.max_fill_, 1.0);
+          }
+        }
+      }
+    });
+    std::vector<std::thread> threads;
+    for (int tid = 1; tid <= 2; tid++) {
+      threads.emplace_back([&, tid] {
+        for (int round = 0; round < 3; round++) {
+          InsertHelper(&tree, churn_keys, tid);
+          DeleteHelper(&tree, churn_keys, tid);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    churning = false;
+    stats_thread.join();
+
+    auto stats = tree.GetStats();
+    EXPECT_EQ(stable_keys.size(), stats.num_keys_);
+    EXPECT_EQ(1, stats.min_key_.ToString());
+    EXPECT_EQ(399, stats.max_key_.ToString());
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete key_schema;
+    delete disk_manager;
+    delete bpm;
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
 /*
  * Score: 5
  * Description: Concurrently insert a set of keys.
@@ -610,4 +930,65 @@ TEST(BPlusTreeConcurrentTest, MixTest3) {
   remove("test.log");
   TEST_TIMEOUT_FAIL_END(1000 * 600)
 }
+
+
+/*
+ * Description: Concurrently append serial keys, which all go through
+ * the cached rightmost leaf.
+ */
+TEST(BPlusTreeConcurrentTest, AppendTest) {
+  TEST_TIMEOUT_BEGIN
+  AppendCall();
+  remove("test.db");
+  remove("test.log");
+  TEST_TIMEOUT_FAIL_END(1000 * 600)
+}
+/*
+ * Description: Forward and reverse full scans run while other threads
+ * insert and delete keys between the scanned ones. Scans must stay
+ * ordered, see every stable key and never deadlock with the writers.
+ */
+TEST(BPlusTreeConcurrentTest, ScanDuringChurnTest) {
+  TEST_TIMEOUT_BEGIN
+  ScanDuringChurnCall();
+  remove("test.db");
+  remove("test.log");
+  TEST_TIMEOUT_FAIL_END(1000 * 600)
+}
+
+/*
+ * Description: Deletes under MergePolicy::LAZY run while another thread
+ * compacts the sparse leaves they leave behind.
+ */
+TEST(BPlusTreeConcurrentTest, LazyMergeTest) {
+  TEST_TIMEOUT_BEGIN
+  LazyMergeCall();
+  remove("test.db");
+  remove("test.log");
+  TEST_TIMEOUT_FAIL_END(1000 * 600)
+}
+
+/*
+ * Description: Range scans in both directions run while deletes under
+ * MergePolicy::LAZY empty out whole leaves.
+ */
+TEST(BPlusTreeConcurrentTest, LazyScanTest) {
+  TEST_TIMEOUT_BEGIN
+  LazyScanCall();
+  remove("test.db");
+  remove("test.log");
+  TEST_TIMEOUT_FAIL_END(1000 * 600)
+}
+
+/*
+ * Description: GetStats walks the tree while writers split and merge its
+ * pages.
+ */
+TEST(BPlusTreeConcurrentTest, StatsDuringChurnTest) {
+  TEST_TIMEOUT_BEGIN
+  StatsDuringChurnCall();
+  remove("test.db");
+  remove("test.log");
+  TEST_TIMEOUT_FAIL_END(1000 * 600)
+}
 }  // namespace bustub
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <set>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -172,4 +173,166 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, ReverseIteratorTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree with small nodes so that deletes coalesce and redistribute
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::set<int64_t> alive;
+  for (int64_t key = 1; key <= 100; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+    alive.insert(key);
+  }
+  for (int64_t key = 3; key <= 100; key += 3) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+    alive.erase(key);
+  }
+  for (int64_t key = 40; key <= 80; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+    alive.erase(key);
+  }
+
+  // full reverse scan follows the prev links maintained by split/coalesce
+  std::vector<int64_t> expected(alive.rbegin(), alive.rend());
+  std::vector<int64_t> scanned;
+  for (auto iterator = tree.rbegin(); iterator != tree.end(); ++iterator) {
+    scanned.push_back((*iterator).first.ToString());
+  }
+  EXPECT_EQ(scanned, expected);
+
+  // bounded reverse scan over (20, 85], bounds not present in the tree
+  GenericKey<8> high_key;
+  GenericKey<8> low_key;
+  high_key.SetFromInteger(85);
+  low_key.SetFromInteger(20);
+  expected.clear();
+  for (auto key = alive.rbegin(); key != alive.rend(); ++key) {
+    if (*key <= 85 && *key > 20) {
+      expected.push_back(*key);
+    }
+  }
+  scanned.clear();
+  for (auto iterator = tree.RBegin(&high_key, &low_key, true, false); iterator != tree.end(); ++iterator) {
+    scanned.push_back((*iterator).first.ToString());
+  }
+  EXPECT_EQ(scanned, expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, LazyMergeTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // the same keys go to an eager and a lazy tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> eager_tree("foo_pk", bpm, comparator, 4, 4);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> lazy_tree("bar_pk", bpm, comparator, 4, 4);
+  lazy_tree.SetMergePolicy(MergePolicy::LAZY);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *eager_txn = new Transaction(0);
+  Transaction *lazy_txn = new Transaction(1);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  for (int64_t key = 1; key <= 200; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    eager_tree.Insert(index_key, rid, eager_txn);
+    lazy_tree.Insert(index_key, rid, lazy_txn);
+  }
+  // delete and reinsert the same range, then leave it sparse
+  for (int round = 0; round < 3; round++) {
+    for (int64_t key = 1; key <= 200; key++) {
+      if (key % 4 != 0) {
+        index_key.SetFromInteger(key);
+        eager_tree.Remove(index_key, eager_txn);
+        lazy_tree.Remove(index_key, lazy_txn);
+      }
+    }
+    if (round == 2) {
+      break;
+    }
+    for (int64_t key = 1; key <= 200; key++) {
+      if (key % 4 != 0) {
+        rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+        index_key.SetFromInteger(key);
+        eager_tree.Insert(index_key, rid, eager_txn);
+        lazy_tree.Insert(index_key, rid, lazy_txn);
+      }
+    }
+  }
+  // the lazy tree only gave back pages of leaves that became empty
+  EXPECT_LT(lazy_txn->GetDeletedPageSet()->size(), eager_txn->GetDeletedPageSet()->size());
+
+  // compaction merges the sparse leaves until there is nothing left to do
+  size_t freed = lazy_tree.Compact(lazy_txn);
+  EXPECT_LT(0, freed);
+  for (int pass = 0; pass < 10 && freed > 0; pass++) {
+    freed = lazy_tree.Compact(lazy_txn);
+  }
+  EXPECT_EQ(0, freed);
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 200; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 4 == 0, lazy_tree.GetValue(index_key, &rids));
+  }
+  int64_t expected = 4;
+  for (auto iterator = lazy_tree.begin(); iterator != lazy_tree.end(); ++iterator) {
+    EXPECT_EQ(expected, (*iterator).first.ToString());
+    expected += 4;
+  }
+  EXPECT_EQ(204, expected);
+
+  // with everything removed lazily the tree is empty again
+  for (int64_t key = 4; key <= 200; key += 4) {
+    index_key.SetFromInteger(key);
+    lazy_tree.Remove(index_key, lazy_txn);
+  }
+  EXPECT_TRUE(lazy_tree.IsEmpty());
+  EXPECT_EQ(0, lazy_tree.Compact(lazy_txn));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete eager_txn;
+  delete lazy_txn;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -4,6 +4,9 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
@@ -141,4 +144,595 @@ TEST(BPlusTreeTests, InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+TEST(BPlusTreeTests, SequentialInsertTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree, a leaf holds at most 4 pairs
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  int64_t scale = 100;
+  for (int64_t key = 1; key <= scale; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  // duplicates of the last key must not sneak in through the append path
+  index_key.SetFromInteger(scale);
+  EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
+
+  // serial inserts split right-biased, so every leaf is left full
+  index_key.SetFromInteger(1);
+  Page *page = tree.FindLeafPageForRead(index_key);
+  ASSERT_NE(nullptr, page);
+  page->RUnlatch();
+  int leaf_count = 0;
+  while (page != nullptr) {
+    auto leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(page->GetData());
+    EXPECT_EQ(4, leaf->GetSize());
+    leaf_count++;
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(page->GetPageId(), false);
+    page = next_page_id == INVALID_PAGE_ID ? nullptr : bpm->FetchPage(next_page_id);
+  }
+  EXPECT_EQ(scale / 4, leaf_count);
+
+  // out of order inserts and deletes next to the underfull rightmost leaf
+  for (int64_t key = scale + 1; key <= scale + 2; key++) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  for (int64_t key = 10; key <= scale + 2; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  for (int64_t key = 10; key <= scale + 2; key += 4) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  int64_t expected = 1;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    while (expected >= 10 && expected % 2 == 0 && (expected - 10) % 4 != 0) {
+      expected++;
+    }
+    EXPECT_EQ(expected, (*iterator).first.ToString());
+    expected++;
+  }
+  EXPECT_EQ(scale + 2, expected - 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, GetValuesTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree with small nodes so that the probes span many leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys only
+  for (int64_t key = 0; key < 200; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // dense run, a duplicate, missing keys, a large jump and keys past the end
+  std::vector<int64_t> probes = {-1, 0, 1, 2, 4, 4, 5, 6, 8, 10, 12, 14, 120, 121, 122, 190, 198, 199, 500};
+  std::vector<GenericKey<8>> keys;
+  for (auto probe : probes) {
+    index_key.SetFromInteger(probe);
+    keys.push_back(index_key);
+  }
+  std::vector<std::vector<RID>> results;
+  int found = tree.GetValues(keys, &results, transaction);
+
+  ASSERT_EQ(results.size(), probes.size());
+  int expected_found = 0;
+  for (size_t i = 0; i < probes.size(); ++i) {
+    bool present = probes[i] >= 0 && probes[i] < 200 && probes[i] % 2 == 0;
+    if (present) {
+      ++expected_found;
+      ASSERT_EQ(results[i].size(), 1);
+      EXPECT_EQ(results[i][0].GetSlotNum(), probes[i]);
+    } else {
+      EXPECT_TRUE(results[i].empty());
+    }
+  }
+  EXPECT_EQ(found, expected_found);
+
+  // no pages should stay pinned or latched after the batch
+  std::vector<RID> rids;
+  index_key.SetFromInteger(100);
+  EXPECT_TRUE(tree.GetValue(index_key, &rids));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, RangeScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys only
+  for (int64_t key = 0; key < 100; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  auto scan = [&](const int64_t *low, const int64_t *high, bool low_inclusive, bool high_inclusive) {
+    GenericKey<8> low_key;
+    GenericKey<8> high_key;
+    if (low != nullptr) {
+      low_key.SetFromInteger(*low);
+    }
+    if (high != nullptr) {
+      high_key.SetFromInteger(*high);
+    }
+    std::vector<int64_t> keys;
+    for (auto iterator = tree.Begin(low == nullptr ? nullptr : &low_key, high == nullptr ? nullptr : &high_key,
+                                    low_inclusive, high_inclusive);
+         iterator != tree.end(); ++iterator) {
+      keys.push_back((*iterator).second.GetSlotNum());
+    }
+    return keys;
+  };
+  auto expect = [](int64_t from, int64_t to) {
+    std::vector<int64_t> keys;
+    for (int64_t key = from; key <= to; key += 2) {
+      keys.push_back(key);
+    }
+    return keys;
+  };
+
+  int64_t low = 10;
+  int64_t high = 20;
+  EXPECT_EQ(scan(&low, &high, true, true), expect(10, 20));
+  EXPECT_EQ(scan(&low, &high, false, false), expect(12, 18));
+  EXPECT_EQ(scan(&low, nullptr, true, true), expect(10, 98));
+  EXPECT_EQ(scan(nullptr, &high, true, false), expect(0, 18));
+  // bounds that are not in the tree
+  low = 11;
+  high = 21;
+  EXPECT_EQ(scan(&low, &high, true, true), expect(12, 20));
+  // low key past the end of a leaf and past the end of the tree
+  low = 97;
+  EXPECT_EQ(scan(&low, nullptr, true, true), expect(98, 98));
+  low = 99;
+  EXPECT_TRUE(scan(&low, nullptr, true, true).empty());
+  // empty range
+  low = 30;
+  high = 30;
+  EXPECT_TRUE(scan(&low, &high, false, true).empty());
+  EXPECT_EQ(scan(&low, &high, true, true), expect(30, 30));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+TEST(BPlusTreeTests, BulkLoadTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  for (int64_t scale : {1, 4, 5, 97}) {
+    for (size_t num_threads : {1, 3}) {
+      // create b+ tree, a leaf holds at most 4 pairs
+      BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+      // odd keys only
+      std::vector<std::pair<GenericKey<8>, RID>> items;
+      for (int64_t key = 1; key < 2 * scale; key += 2) {
+        rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+        index_key.SetFromInteger(key);
+        items.emplace_back(index_key, rid);
+      }
+      tree.BulkLoad(items, num_threads, transaction);
+
+      std::vector<RID> rids;
+      for (int64_t key = 0; key <= 2 * scale; key++) {
+        rids.clear();
+        index_key.SetFromInteger(key);
+        EXPECT_EQ(key % 2 == 1, tree.GetValue(index_key, &rids));
+        if (key % 2 == 1) {
+          ASSERT_EQ(1, rids.size());
+          EXPECT_EQ(key, rids[0].GetSlotNum());
+        }
+      }
+      // both directions walk the sibling links
+      int64_t expected = 1;
+      for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+        EXPECT_EQ(expected, (*iterator).first.ToString());
+        expected += 2;
+      }
+      EXPECT_EQ(2 * scale + 1, expected);
+      for (auto iterator = tree.rbegin(); iterator != tree.end(); ++iterator) {
+        expected -= 2;
+        EXPECT_EQ(expected, (*iterator).first.ToString());
+      }
+      EXPECT_EQ(1, expected);
+
+      // the loaded tree takes ordinary inserts and deletes
+      for (int64_t key = 0; key <= 2 * scale; key += 2) {
+        rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+      }
+      for (int64_t key = 1; key < 2 * scale; key += 2) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, transaction);
+      }
+      expected = 0;
+      for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+        EXPECT_EQ(expected, (*iterator).first.ToString());
+        expected += 2;
+      }
+      EXPECT_EQ(2 * scale + 2, expected);
+      for (int64_t key = 0; key <= 2 * scale; key += 2) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, transaction);
+      }
+      EXPECT_TRUE(tree.IsEmpty());
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+TEST(BPlusTreeTests, IntegerKeyTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // no key schema, the key type is the native integer
+  IntegerComparator<int32_t> comparator;
+  BPlusTree<IntegerKey<int32_t>, RID, IntegerComparator<int32_t>> tree("foo_pk", bpm, comparator, 3, 4);
+  IntegerKey<int32_t> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // negative keys must sort before positive ones
+  std::vector<int32_t> keys;
+  for (int32_t key = -100; key <= 100; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(0, key + 100);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  int32_t expected = -100;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(expected, (*iterator).first.ToString());
+    EXPECT_EQ(expected + 100, (*iterator).second.GetSlotNum());
+    expected++;
+  }
+  EXPECT_EQ(101, expected);
+
+  for (int32_t key = -100; key <= 100; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  std::vector<RID> rids;
+  for (int32_t key = -100; key <= 100; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 != 0, tree.GetValue(index_key, &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, StatsTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  EXPECT_EQ(0, tree.GetStats().height_);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 1000; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  auto stats = tree.GetStats();
+  ASSERT_LT(2, stats.height_);
+  ASSERT_EQ(stats.height_, stats.levels_.size());
+  EXPECT_EQ(1, stats.levels_[0].num_pages_);
+  EXPECT_EQ(1000, stats.num_keys_);
+  EXPECT_EQ(1, stats.min_key_.ToString());
+  EXPECT_EQ(1000, stats.max_key_.ToString());
+  for (size_t level = 0; level < stats.levels_.size(); level++) {
+    const auto &level_stats = stats.levels_[level];
+    EXPECT_EQ(level_stats.num_pages_, level_stats.num_sampled_);
+    EXPECT_LE(level_stats.min_fill_, level_stats.avg_fill_);
+    EXPECT_LE(level_stats.avg_fill_, level_stats.max_fill_);
+    EXPECT_LE(level_stats.max_fill_, 1.0);
+    if (level > 0) {
+      // every page below the root is at least half full after inserts only
+      EXPECT_LE(0.5, level_stats.min_fill_);
+      EXPECT_LT(stats.levels_[level - 1].num_pages_, level_stats.num_pages_);
+    }
+  }
+  // the leaves hold every key once
+  const auto &leaves = stats.levels_.back();
+  EXPECT_NEAR(1000.0, leaves.avg_fill_ * 4 * leaves.num_pages_, 1e-6);
+
+  // sampling reads fewer leaves but counts all of them
+  auto sampled = tree.GetStats(0.1);
+  EXPECT_EQ(stats.height_, sampled.height_);
+  EXPECT_EQ(leaves.num_pages_, sampled.levels_.back().num_pages_);
+  EXPECT_GT(leaves.num_pages_ / 2, sampled.levels_.back().num_sampled_);
+  EXPECT_NEAR(1000.0, sampled.num_keys_, 250.0);
+  EXPECT_EQ(1, sampled.min_key_.ToString());
+  EXPECT_EQ(1000, sampled.max_key_.ToString());
+  for (size_t level = 0; level + 1 < stats.levels_.size(); level++) {
+    EXPECT_EQ(stats.levels_[level].num_pages_, sampled.levels_[level].num_pages_);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BloomFilterTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // only even keys are inserted, half of them before the filter is built from the leaves
+  const int64_t num_keys = 10000;
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  tree.SetBloomFilter(num_keys, 0.01);
+  for (int64_t key = num_keys; key < 2 * num_keys; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  std::vector<RID> rids;
+  std::vector<GenericKey<8>> keys;
+  for (int64_t key = 0; key < 2 * num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    keys.push_back(index_key);
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &rids));
+  }
+  std::vector<std::vector<RID>> results;
+  EXPECT_EQ(num_keys, tree.GetValues(keys, &results, transaction));
+  for (int64_t key = 0; key < 2 * num_keys; key++) {
+    EXPECT_EQ(key % 2 == 0 ? 1 : 0, results[key].size());
+  }
+
+  // removed keys are no longer found even though the filter still has them
+  for (int64_t key = 0; key < 100; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+    rids.clear();
+    EXPECT_FALSE(tree.GetValue(index_key, &rids));
+  }
+  tree.SetBloomFilter(0);
+  index_key.SetFromInteger(102);
+  rids.clear();
+  EXPECT_TRUE(tree.GetValue(index_key, &rids));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BloomFilterFalsePositiveTest) {
+  BloomFilter filter(10000, 0.01);
+  for (int64_t key = 0; key < 10000; key++) {
+    filter.Add(BloomFilter::Hash(reinterpret_cast<const char *>(&key), sizeof(key)));
+  }
+  int false_positives = 0;
+  for (int64_t key = 0; key < 20000; key++) {
+    bool may_contain = filter.MayContain(BloomFilter::Hash(reinterpret_cast<const char *>(&key), sizeof(key)));
+    if (key < 10000) {
+      EXPECT_TRUE(may_contain);
+    } else if (may_contain) {
+      false_positives++;
+    }
+  }
+  EXPECT_GT(300, false_positives);
+}
+
+TEST(BPlusTreeTests, AdaptiveHashIndexTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4);
+  tree.SetAdaptiveHashIndex(64);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_keys = 1000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  // the hot keys get cached, and every lookup must still see the current tree
+  auto check = [&](int64_t key, bool expected) {
+    for (int i = 0; i < 2 * AdaptiveHashIndex::HOT_LOOKUPS; i++) {
+      std::vector<RID> rids;
+      index_key.SetFromInteger(key);
+      ASSERT_EQ(expected, tree.GetValue(index_key, &rids));
+      if (expected) {
+        ASSERT_EQ(1, rids.size());
+        ASSERT_EQ(key, rids[0].GetSlotNum());
+      }
+    }
+  };
+  for (int64_t key = 0; key < num_keys; key += 10) {
+    check(key, true);
+  }
+  // removing the odd keys merges and redistributes leaves, the cached slots move or go away
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  for (int64_t key = 0; key < num_keys; key += 5) {
+    check(key, key % 2 == 0);
+  }
+  // removing the cached keys themselves
+  for (int64_t key = 0; key < num_keys / 2; key += 10) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  // inserting the odd keys back splits the leaves
+  for (int64_t key = 1; key < num_keys; key += 2) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  for (int64_t key = 0; key < num_keys; key++) {
+    check(key, key % 2 == 1 || key >= num_keys / 2 || key % 10 != 0);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -0,0 +1,176 @@
+/**
+ * b_plus_tree_key_search_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/simd_key_search.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+template <size_t KeySize, typename IntType>
+GenericKey<KeySize> MakeKey(IntType value) {
+  GenericKey<KeySize> key;
+  memset(key.data_, 0, KeySize);
+  memcpy(key.data_, &value, sizeof(IntType));
+  return key;
+}
+
+/*
+ * Sorted (key, rid) pairs laid out the same way as a leaf page array.
+ */
+template <size_t KeySize, typename IntType>
+std::vector<std::pair<GenericKey<KeySize>, RID>> MakeSortedArray(int size, std::mt19937 *gen) {
+  std::uniform_int_distribution<IntType> dist(-1000, 1000);
+  std::vector<IntType> values(size);
+  for (auto &v : values) {
+    v = dist(*gen);
+  }
+  std::sort(values.begin(), values.end());
+  std::vector<std::pair<GenericKey<KeySize>, RID>> array;
+  for (int i = 0; i < size; ++i) {
+    array.emplace_back(MakeKey<KeySize>(values[i]), RID(0, i));
+  }
+  return array;
+}
+
+template <size_t KeySize, typename IntType>
+void CheckUpperBound(const char *sql) {
+  Schema *key_schema = ParseCreateStatement(sql);
+  GenericComparator<KeySize> comparator(key_schema);
+  ASSERT_EQ(IntegerKeyWidth(comparator), sizeof(IntType));
+
+  std::mt19937 gen(15445);
+  for (int size = 0; size < 300; size += 7) {
+    auto array = MakeSortedArray<KeySize, IntType>(size, &gen);
+    for (IntType probe = -1010; probe <= 1010; probe += 3) {
+      auto key = MakeKey<KeySize>(probe);
+      for (int lo = 0; lo <= std::min(size, 1); ++lo) {
+        int expected = KeyUpperBoundGeneric(array.data(), lo, size, key, comparator);
+        ASSERT_EQ(expected, KeyUpperBound(array.data(), lo, size, key, comparator));
+      }
+    }
+  }
+  delete key_schema;
+}
+
+TEST(BPlusTreeKeySearchTest, IntegerKeyWidth) {
+  Schema *int_schema = ParseCreateStatement("a int");
+  Schema *bigint_schema = ParseCreateStatement("a bigint");
+  Schema *composite_schema = ParseCreateStatement("a int,b int");
+  EXPECT_EQ(4, GenericComparator<4>(int_schema).GetIntegerKeyWidth());
+  EXPECT_EQ(4, GenericComparator<8>(int_schema).GetIntegerKeyWidth());
+  EXPECT_EQ(0, GenericComparator<4>(bigint_schema).GetIntegerKeyWidth());
+  EXPECT_EQ(8, GenericComparator<8>(bigint_schema).GetIntegerKeyWidth());
+  EXPECT_EQ(0, GenericComparator<8>(composite_schema).GetIntegerKeyWidth());
+  delete int_schema;
+  delete bigint_schema;
+  delete composite_schema;
+}
+
+TEST(BPlusTreeKeySearchTest, UpperBound32) { CheckUpperBound<4, int32_t>("a int"); }
+
+TEST(BPlusTreeKeySearchTest, UpperBound64) { CheckUpperBound<8, int64_t>("a bigint"); }
+
+/*
+ * Microbenchmark: integer fast path against the comparator binary search, on
+ * a full leaf worth of keys.
+ */
+template <size_t KeySize, typename IntType>
+void BenchmarkUpperBound(const char *sql) {
+  Schema *key_schema = ParseCreateStatement(sql);
+  GenericComparator<KeySize> comparator(key_schema);
+  const int size = static_cast<int>((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<KeySize>, RID>));
+  const int rounds = 200000;
+
+  std::mt19937 gen(15445);
+  auto array = MakeSortedArray<KeySize, IntType>(size, &gen);
+  std::uniform_int_distribution<IntType> dist(-1000, 1000);
+  std::vector<GenericKey<KeySize>> probes;
+  for (int i = 0; i < rounds; ++i) {
+    probes.push_back(MakeKey<KeySize>(dist(gen)));
+  }
+
+  int64_t checksum[2] = {0, 0};
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &probe : probes) {
+    checksum[0] += KeyUpperBoundGeneric(array.data(), 0, size, probe, comparator);
+  }
+  auto mid = std::chrono::steady_clock::now();
+  for (const auto &probe : probes) {
+    checksum[1] += KeyUpperBound(array.data(), 0, size, probe, comparator);
+  }
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_EQ(checksum[0], checksum[1]);
+
+  auto generic_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(mid - start).count();
+  auto simd_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - mid).count();
+  printf("key width %zu, %d keys per node: comparator %.1f ns/search, integer %.1f ns/search\n", sizeof(IntType), size,
+         static_cast<double>(generic_ns) / rounds, static_cast<double>(simd_ns) / rounds);
+  delete key_schema;
+}
+
+TEST(BPlusTreeKeySearchTest, DISABLED_Benchmark32) { BenchmarkUpperBound<4, int32_t>("a int"); }
+
+TEST(BPlusTreeKeySearchTest, DISABLED_Benchmark64) { BenchmarkUpperBound<8, int64_t>("a bigint"); }
+
+/*
+ * Benchmark: the same BIGINT keys through a GenericKey tree and an IntegerKey
+ * tree, random inserts then point lookups.
+ */
+template <typename KeyType, typename KeyComparator>
+void BenchmarkTree(const char *name, const KeyComparator &comparator, const std::vector<int64_t> &keys) {
+  DiskManager disk_manager("test.db");
+  BufferPoolManager bpm(50000, &disk_manager);
+  page_id_t page_id;
+  bpm.NewPage(&page_id);
+  BPlusTree<KeyType, RID, KeyComparator> tree("foo_pk", &bpm, comparator);
+  Transaction transaction(0);
+  KeyType index_key;
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(0, static_cast<uint32_t>(key)), &transaction);
+  }
+  auto mid = std::chrono::steady_clock::now();
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids, &transaction);
+  }
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_EQ(keys.size(), rids.size());
+
+  auto insert_ms = std::chrono::duration_cast<std::chrono::milliseconds>(mid - start).count();
+  auto lookup_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - mid).count();
+  printf("%s: %zu keys, insert %ld ms, lookup %ld ms\n", name, keys.size(), static_cast<int64_t>(insert_ms),
+         static_cast<int64_t>(lookup_ms));
+  bpm.UnpinPage(HEADER_PAGE_ID, true);
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeKeySearchTest, DISABLED_BenchmarkIntegerKeyTree) {
+  std::vector<int64_t> keys(1000000);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  BenchmarkTree<GenericKey<8>>("GenericKey<8>", GenericComparator<8>(key_schema), keys);
+  BenchmarkTree<IntegerKey<int64_t>>("IntegerKey<int64_t>", IntegerComparator<int64_t>(), keys);
+  delete key_schema;
+}
+
+}  // namespace bustub
@@ -0,0 +1,213 @@
+/**
+ * b_plus_tree_varlen_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree_varlen.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// keys longer than any GenericKey, differing only after a long common prefix
+std::string LongVarlenKey(int i) {
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), "%05d", i);
+  return std::string(100, 'p') + suffix;
+}
+
+TEST(BPlusTreeVarlenTests, InsertTest) {
+  Schema *key_schema = ParseCreateStatement("a varchar(256)");
+  VarlenComparator comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  VarlenBPlusTree tree("foo_pk", bpm, comparator);
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // short keys only take the bytes they need, far more than a GenericKey<64> leaf holds fit in the root
+  for (int i = 0; i < 100; i++) {
+    Tuple key({ValueFactory::GetVarcharValue(std::to_string(i))}, key_schema);
+    EXPECT_TRUE(tree.Insert(VarlenKey(key), RID(0, i), transaction));
+  }
+  Page *root = bpm->FetchPage(tree.GetRootPageId());
+  EXPECT_TRUE(reinterpret_cast<BPlusTreePage *>(root->GetData())->IsLeafPage());
+  bpm->UnpinPage(root->GetPageId(), false);
+  for (int i = 0; i < 100; i++) {
+    Tuple key({ValueFactory::GetVarcharValue(std::to_string(i))}, key_schema);
+    tree.Remove(VarlenKey(key), transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  std::vector<int> keys(2000);
+  for (int i = 0; i < static_cast<int>(keys.size()); i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto i : keys) {
+    Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+    EXPECT_TRUE(tree.Insert(VarlenKey(key), RID(i, i), transaction));
+  }
+  // duplicate and oversized keys are rejected
+  Tuple dup_key({ValueFactory::GetVarcharValue(LongVarlenKey(7))}, key_schema);
+  EXPECT_FALSE(tree.Insert(VarlenKey(dup_key), RID(0, 0), transaction));
+  Tuple big_key({ValueFactory::GetVarcharValue(std::string(VarlenBPlusTree::MAX_KEY_SIZE, 'x'))}, key_schema);
+  EXPECT_FALSE(tree.Insert(VarlenKey(big_key), RID(0, 0), transaction));
+
+  std::vector<RID> rids;
+  for (auto i : keys) {
+    rids.clear();
+    Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+    EXPECT_TRUE(tree.GetValue(VarlenKey(key), &rids));
+    EXPECT_EQ(1, rids.size());
+    EXPECT_EQ(i, rids[0].GetSlotNum());
+  }
+
+  int expected = 0;
+  for (auto iterator = tree.Begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ(LongVarlenKey(expected), VarlenKey((*iterator).first).ToValue(key_schema, 0).ToString());
+    EXPECT_EQ(expected, (*iterator).second.GetSlotNum());
+    expected++;
+  }
+  EXPECT_EQ(keys.size(), expected);
+
+  Tuple start_key({ValueFactory::GetVarcharValue(LongVarlenKey(1500))}, key_schema);
+  expected = 1500;
+  for (auto iterator = tree.Begin(VarlenKey(start_key)); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ(expected, (*iterator).second.GetSlotNum());
+    expected++;
+  }
+  EXPECT_EQ(keys.size(), expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeVarlenTests, DeleteTest) {
+  Schema *key_schema = ParseCreateStatement("a varchar(256)");
+  VarlenComparator comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  VarlenBPlusTree tree("foo_pk", bpm, comparator);
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int> keys(2000);
+  for (int i = 0; i < static_cast<int>(keys.size()); i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto i : keys) {
+    Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+    EXPECT_TRUE(tree.Insert(VarlenKey(key), RID(i, i), transaction));
+  }
+
+  // remove the even keys, pages merge and the freed heap bytes are reused by later inserts
+  for (auto i : keys) {
+    if (i % 2 == 0) {
+      Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+      tree.Remove(VarlenKey(key), transaction);
+    }
+  }
+  std::vector<RID> rids;
+  for (int i = 0; i < static_cast<int>(keys.size()); i++) {
+    rids.clear();
+    Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+    EXPECT_EQ(i % 2 != 0, tree.GetValue(VarlenKey(key), &rids));
+  }
+  int expected = 1;
+  for (auto iterator = tree.Begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ(expected, (*iterator).second.GetSlotNum());
+    expected += 2;
+  }
+  EXPECT_EQ(keys.size() + 1, expected);
+
+  for (auto i : keys) {
+    Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+    tree.Remove(VarlenKey(key), transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  EXPECT_TRUE(tree.Begin().isEnd());
+
+  // every page was given back, the tree grows again from an empty root
+  for (auto i : keys) {
+    Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+    EXPECT_TRUE(tree.Insert(VarlenKey(key), RID(i, i), transaction));
+  }
+  for (auto i : keys) {
+    rids.clear();
+    Tuple key({ValueFactory::GetVarcharValue(LongVarlenKey(i))}, key_schema);
+    EXPECT_TRUE(tree.GetValue(VarlenKey(key), &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeVarlenTests, CompositeKeyTest) {
+  Schema *key_schema = ParseCreateStatement("a integer,b varchar(64)");
+  VarlenComparator comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  VarlenBPlusTree tree("foo_pk", bpm, comparator);
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // ordered by the integer first, then by the string, where a prefix sorts first
+  std::vector<std::string> strings = {"b", "ba", "a", "", "abc", "ab"};
+  for (int a = 3; a >= 0; a--) {
+    for (size_t j = 0; j < strings.size(); j++) {
+      Tuple key({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(strings[j])}, key_schema);
+      EXPECT_TRUE(tree.Insert(VarlenKey(key), RID(a, j), transaction));
+    }
+  }
+  std::vector<std::string> sorted = {"", "a", "ab", "abc", "b", "ba"};
+  size_t count = 0;
+  for (auto iterator = tree.Begin(); !iterator.isEnd(); ++iterator, ++count) {
+    VarlenKey key((*iterator).first);
+    EXPECT_EQ(static_cast<int>(count / sorted.size()), key.ToValue(key_schema, 0).GetAs<int32_t>());
+    EXPECT_EQ(sorted[count % sorted.size()], key.ToValue(key_schema, 1).ToString());
+  }
+  EXPECT_EQ(4 * strings.size(), count);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+}  // namespace bustub
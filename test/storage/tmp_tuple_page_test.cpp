@@ -19,7 +19,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -46,6 +46,78 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+
+  ASSERT_EQ(tmp_tuple, TmpTuple(page_id, PAGE_SIZE - 8));
+  Tuple read;
+  page.Get(tmp_tuple, &read);
+  ASSERT_EQ(read.GetValue(&schema, 0).GetAs<int32_t>(), 123);
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, FillTest) {
+  TmpTuplePage page{};
+  page.Init(0, PAGE_SIZE);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 16);
+  Schema schema(columns);
+
+  int32_t num_tuples = 0;
+  uint32_t tuple_size = 0;
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  while (true) {
+    Tuple tuple({ValueFactory::GetIntegerValue(num_tuples), ValueFactory::GetVarcharValue("abcd")}, &schema);
+    tuple_size = tuple.GetLength();
+    if (!page.Insert(tuple, &tmp_tuple)) {
+      break;
+    }
+    num_tuples++;
+  }
+  // every tuple takes its data and a 4 byte size
+  ASSERT_EQ(num_tuples, (PAGE_SIZE - 12) / (tuple_size + 4));
+
+  std::vector<Tuple> tuples;
+  page.GetTuples(&tuples);
+  ASSERT_EQ(tuples.size(), num_tuples);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    ASSERT_EQ(tuples[i].GetValue(&schema, 0).GetAs<int32_t>(), num_tuples - 1 - i);
+    ASSERT_EQ(tuples[i].GetValue(&schema, 1).ToString(), "abcd");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, RidTest) {
+  TmpTuplePage page{};
+  page.Init(0, PAGE_SIZE);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 16);
+  Schema schema(columns);
+
+  int32_t num_tuples = 0;
+  uint32_t tuple_size = 0;
+  while (true) {
+    Tuple tuple({ValueFactory::GetIntegerValue(num_tuples), ValueFactory::GetVarcharValue("abcd")}, &schema);
+    tuple_size = tuple.GetLength();
+    if (!page.Insert(tuple, RID(num_tuples, 2 * num_tuples))) {
+      break;
+    }
+    num_tuples++;
+  }
+  // every tuple takes its data, a 4 byte size and an 8 byte rid
+  ASSERT_EQ(num_tuples, (PAGE_SIZE - 12) / (tuple_size + 12));
+
+  std::vector<Tuple> tuples;
+  page.GetTuplesWithRids(&tuples);
+  ASSERT_EQ(tuples.size(), num_tuples);
+  for (int32_t i = 0; i < num_tuples; i++) {
+    int32_t a = num_tuples - 1 - i;
+    ASSERT_EQ(tuples[i].GetValue(&schema, 0).GetAs<int32_t>(), a);
+    ASSERT_EQ(tuples[i].GetValue(&schema, 1).ToString(), "abcd");
+    ASSERT_EQ(tuples[i].GetRid(), RID(a, 2 * a));
+  }
 }
 
 }  // namespace bustub